@@ -0,0 +1,243 @@
+// The libMesh Finite Element Library.
+// Copyright (C) 2002-2012 Benjamin S. Kirk, John W. Peterson, Roy H. Stogner
+
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+
+#ifndef LIBMESH_BENCHMARK_H
+#define LIBMESH_BENCHMARK_H
+
+// Local includes
+#include "libmesh/libmesh_common.h"
+#include "libmesh/enum_elem_type.h"
+#include "libmesh/parallel.h"
+
+// C++ includes
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace libMesh
+{
+
+// Forward Declarations
+class UnstructuredMesh;
+
+/**
+ * A \p Benchmark times one operation.  The operation is run a fixed
+ * number of times; each run is preceded by an untimed \p setup() and
+ * followed by an untimed \p teardown(), so that operations which
+ * modify their input (refinement, dof distribution) start from the
+ * same state every time.  Each run reports the amount of work it did,
+ * in \p units(), so that results can be compared as throughput.
+ *
+ * Benchmarks are created before \p LibMeshInit, by the static
+ * \p BenchmarkRegistry::Add objects in each benchmark source file, so
+ * their constructors must not touch any libMesh data.  Everything
+ * else should be built in \p init(), and released in \p clear().
+ */
+class Benchmark
+{
+public:
+
+  /**
+   * Constructor.  \p name should be unique, and is of the form
+   * "area/operation/parameters".
+   */
+  Benchmark (const std::string &name,
+             const std::string &units) :
+    _name(name),
+    _units(units),
+    _comm(NULL),
+    _scale(1)
+  {}
+
+  /**
+   * Destructor.
+   */
+  virtual ~Benchmark () {}
+
+  /**
+   * @returns the name of the benchmark.
+   */
+  const std::string & name () const { return _name; }
+
+  /**
+   * @returns the units of the work done by each run.
+   */
+  const std::string & units () const { return _units; }
+
+  /**
+   * Prepares the benchmark to run on \p comm.  Problem sizes are
+   * multiplied by \p scale.
+   */
+  void init (const Parallel::Communicator &comm,
+             const unsigned int scale)
+  {
+    _comm = &comm;
+    _scale = scale;
+    this->init();
+  }
+
+  /**
+   * Builds the data shared by all the runs.
+   */
+  virtual void init () {}
+
+  /**
+   * Prepares for one run.  Not timed.
+   */
+  virtual void setup () {}
+
+  /**
+   * Does the operation being timed, and returns the amount of work
+   * done on this processor.
+   */
+  virtual double run () = 0;
+
+  /**
+   * Cleans up after one run.  Not timed.
+   */
+  virtual void teardown () {}
+
+  /**
+   * Releases everything built by \p init().
+   */
+  virtual void clear () {}
+
+protected:
+
+  /**
+   * @returns the communicator to run on.
+   */
+  const Parallel::Communicator & comm () const
+  { libmesh_assert(_comm); return *_comm; }
+
+  /**
+   * @returns the problem size multiplier.
+   */
+  unsigned int scale () const { return _scale; }
+
+  /**
+   * Builds a unit line, square or cube in \p mesh, depending on the
+   * dimension of \p type, with \p n_per_side times \p scale()
+   * elements on each side.
+   */
+  void build_mesh (UnstructuredMesh &mesh,
+                   const ElemType type,
+                   const unsigned int n_per_side) const;
+
+private:
+
+  const std::string _name;
+
+  const std::string _units;
+
+  const Parallel::Communicator *_comm;
+
+  unsigned int _scale;
+};
+
+
+
+/**
+ * The results of running one \p Benchmark.  Times are the maximum
+ * over the processors of the wall time of each run; work is summed
+ * over the processors.
+ */
+struct BenchmarkResult
+{
+  std::string name;
+  std::string units;
+  std::vector<double> times;
+  double work;
+
+  double min () const;
+  double max () const;
+  double mean () const;
+  double median () const;
+};
+
+
+
+/**
+ * The \p BenchmarkRegistry holds every \p Benchmark linked into the
+ * driver, and runs them.
+ */
+class BenchmarkRegistry
+{
+public:
+
+  /**
+   * Registers a benchmark.  The registry takes ownership of
+   * \p benchmark.
+   */
+  static void add (Benchmark *benchmark);
+
+  /**
+   * @returns all registered benchmarks, in name order.
+   */
+  static std::vector<Benchmark *> benchmarks ();
+
+  /**
+   * Deletes all registered benchmarks.
+   */
+  static void clear ();
+
+  /**
+   * Runs \p benchmark \p warmup times untimed and then \p repeat
+   * times timed, on all processors of \p comm.
+   */
+  static BenchmarkResult run (Benchmark &benchmark,
+                              const Parallel::Communicator &comm,
+                              const unsigned int scale,
+                              const unsigned int warmup,
+                              const unsigned int repeat);
+
+  /**
+   * Writes \p results as a table.
+   */
+  static void print_results (std::ostream &os,
+                             const std::vector<BenchmarkResult> &results);
+
+  /**
+   * Writes \p results in JSON, together with a description of the
+   * run, for comparison across commits.  \p label is any string which
+   * identifies the run, e.g. a revision id.
+   */
+  static void write_json (std::ostream &os,
+                          const std::vector<BenchmarkResult> &results,
+                          const Parallel::Communicator &comm,
+                          const unsigned int scale,
+                          const std::string &label);
+
+  /**
+   * Registers a benchmark on construction.  Benchmark sources declare
+   * a static \p Add for each benchmark they define.
+   */
+  class Add
+  {
+  public:
+    Add (Benchmark *benchmark) { BenchmarkRegistry::add(benchmark); }
+  };
+
+private:
+
+  static std::vector<Benchmark *> & registry ();
+};
+
+} // namespace libMesh
+
+#endif // LIBMESH_BENCHMARK_H
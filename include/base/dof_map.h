@@ -1022,6 +1022,15 @@ public:
    */
   std::string get_info() const;
 
+  /**
+   * @returns an estimate of the number of bytes of memory used on
+   * this processor by the degree of freedom numbering, the send
+   * list, the sparsity pattern (if it is still being kept) and the
+   * constraint rows.  The indices stored on each \p DofObject are
+   * counted with the mesh instead.
+   */
+  std::size_t memory_usage() const;
+
   /**
    * Degree of freedom coupling.  If left empty each DOF
    * couples to all others.  Can be used to reduce memory
@@ -377,6 +377,13 @@ public:
    */
   void debug_buffer () const;
 
+  /**
+   * @returns an estimate of the number of bytes of heap memory used
+   * by the degree of freedom indexing of this object, including any
+   * old copy of it.  The object itself is not counted.
+   */
+  std::size_t memory_usage () const;
+
 private:
 
   /**
@@ -18,6 +18,7 @@
       - Metis K-Way weighted graph partitioning
       - Parmetis parallel graph partitioning
       - Hilbert and Morton-ordered space filling curves
+      - Diffusive incremental repartitioning
 
    - Generic 2D Finite Elements
       - 3 and 6 noded triangles (\p Tri3, \p Tri6)
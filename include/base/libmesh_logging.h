@@ -49,14 +49,42 @@ class PerfLog;
 
 
 
+// The level of detail of performance logging.  At level 1, the
+// default when performance logging is enabled, the events logged
+// with START_LOG/STOP_LOG are recorded.  At level 2 the finer grained
+// events logged with START_LOG_FINE/STOP_LOG_FINE, which are meant
+// for the innermost kernels, are recorded too; below that they are
+// compiled away entirely.  Define LIBMESH_PERFLOG_LEVEL before
+// including this file to choose a level.
+#ifndef LIBMESH_PERFLOG_LEVEL
+#  ifdef LIBMESH_ENABLE_PERFORMANCE_LOGGING
+#    define LIBMESH_PERFLOG_LEVEL 1
+#  else
+#    define LIBMESH_PERFLOG_LEVEL 0
+#  endif
+#endif
+
+
+
 // Macros for performance logging.  This allows us
 // to add performance monitors to the code without
 // impacting performance when performance logging
-// is disabled.
-#ifdef LIBMESH_ENABLE_PERFORMANCE_LOGGING
-
-#  define START_LOG(a,b)   { libMesh::perflog.push(a,b); }
-#  define STOP_LOG(a,b)    { libMesh::perflog.pop(a,b); }
+// is disabled.  Events named by string literals are
+// interned once, and their ids are cached where the
+// macro is used.
+#define LIBMESH_PERFLOG_PUSH(a,b)                                        \
+  { static const libMesh::PerfLog::EventSite                           \
+      libmesh_perflog_site(libMesh::perflog,a,b);                      \
+    libMesh::perflog.push(libmesh_perflog_site.event_id(libMesh::perflog,a,b)); }
+#define LIBMESH_PERFLOG_POP(a,b)                                         \
+  { static const libMesh::PerfLog::EventSite                           \
+      libmesh_perflog_site(libMesh::perflog,a,b);                      \
+    libMesh::perflog.pop(libmesh_perflog_site.event_id(libMesh::perflog,a,b)); }
+
+#if LIBMESH_PERFLOG_LEVEL >= 1
+
+#  define START_LOG(a,b)   LIBMESH_PERFLOG_PUSH(a,b)
+#  define STOP_LOG(a,b)    LIBMESH_PERFLOG_POP(a,b)
 #  define PALIBMESH_USE_LOG(a,b)   { libmesh_deprecated(); }
 #  define RESTART_LOG(a,b) { libmesh_deprecated(); }
 
@@ -71,6 +99,22 @@ class PerfLog;
 
 
 
+// Macros for fine grained performance logging, in the innermost
+// kernels.
+#if LIBMESH_PERFLOG_LEVEL >= 2
+
+#  define START_LOG_FINE(a,b) LIBMESH_PERFLOG_PUSH(a,b)
+#  define STOP_LOG_FINE(a,b)  LIBMESH_PERFLOG_POP(a,b)
+
+#else
+
+#  define START_LOG_FINE(a,b) {}
+#  define STOP_LOG_FINE(a,b)  {}
+
+#endif
+
+
+
 
 
 #endif // LIBMESH_LIBMESH_LOGGING_H
@@ -79,7 +79,7 @@ protected:
   {
 #if defined(LIBMESH_ENABLE_REFERENCE_COUNTING) && defined(DEBUG)
 
-    increment_constructor_count(typeid(T).name());
+    increment_constructor_count(type_id());
 
 #endif
   }
@@ -92,7 +92,7 @@ protected:
   {
 #if defined(LIBMESH_ENABLE_REFERENCE_COUNTING) && defined(DEBUG)
 
-    increment_constructor_count(typeid(T).name());
+    increment_constructor_count(type_id());
 
 #endif
   }
@@ -106,16 +106,56 @@ public:
   {
 #if defined(LIBMESH_ENABLE_REFERENCE_COUNTING) && defined(DEBUG)
 
-    increment_destructor_count(typeid(T).name());
+    increment_destructor_count(type_id());
 
 #endif
   }
 
 private:
 
+#if defined(LIBMESH_ENABLE_REFERENCE_COUNTING) && defined(DEBUG)
+
+  /**
+   * @returns the id under which objects of class \p T are counted.
+   * The id is looked up by name only the first time.
+   */
+  static unsigned int type_id ();
+
+  /**
+   * The id of class \p T, or \p libMesh::invalid_uint if it has
+   * not been looked up yet.
+   */
+  static unsigned int _type_id;
+
+#endif
 };
 
 
+
+// ------------------------------------------------------------
+// ReferenceCountedObject class static data and inline methods
+#if defined(LIBMESH_ENABLE_REFERENCE_COUNTING) && defined(DEBUG)
+
+template <typename T>
+unsigned int ReferenceCountedObject<T>::_type_id = libMesh::invalid_uint;
+
+
+
+template <typename T>
+inline
+unsigned int ReferenceCountedObject<T>::type_id ()
+{
+  // Racing threads may both look the id up, but register_type()
+  // gives them the same answer.
+  if (_type_id == libMesh::invalid_uint)
+    _type_id = register_type(typeid(T).name());
+
+  return _type_id;
+}
+
+#endif
+
+
 } // namespace libMesh
 
 
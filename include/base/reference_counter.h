@@ -29,6 +29,8 @@
 #include <iostream>
 #include <string>
 #include <map>
+#include <utility>
+#include <vector>
 
 namespace libMesh
 {
@@ -39,6 +41,16 @@ namespace libMesh
  * This is the base class for enabling reference counting.  It
  * should not be used by the user, thus it has a private constructor.
  *
+ * Each thread counts into its own \p ThreadCounts without locking,
+ * and the counts of a class are kept in a vector indexed by an id
+ * assigned to the class the first time an object of it is
+ * constructed.  The counts of all threads are only summed when they
+ * are read, so constructing and destroying reference counted objects
+ * does not serialize threads.  When a thread exits its counts are
+ * merged into those of the threads which have exited before.
+ * Without pthreads all threads share one \p ThreadCounts under a
+ * lock.
+ *
  * \author Benjamin S. Kirk, 2002-2007
  */
 
@@ -55,6 +67,12 @@ protected:
    */
   ReferenceCounter ();
 
+  /**
+   * Copy constructor.  Copies are counted as new objects, since they
+   * will be destroyed like any other.
+   */
+  ReferenceCounter (const ReferenceCounter&);
+
 public:
 
   /**
@@ -76,8 +94,7 @@ public:
    * Prints the number of outstanding (created, but not yet
    * destroyed) objects.
    */
-  static unsigned int n_objects ()
-  { return _n_objects; }
+  static unsigned int n_objects ();
 
   /**
    * Methods to enable/disable the reference counter output
@@ -92,38 +109,85 @@ protected:
 #if defined(LIBMESH_ENABLE_REFERENCE_COUNTING) && defined(DEBUG)
 
   /**
-   * Increments the construction counter. Should be called in
-   * the constructor of any derived class that will be
-   * reference counted.
+   * @returns the id under which objects of the class \p name are
+   * counted, assigning a new one if \p name has none yet.
+   */
+  static unsigned int register_type (const std::string& name);
+
+  /**
+   * Increments the construction counter of the class with id
+   * \p type_id.  Should be called in the constructor of any derived
+   * class that will be reference counted.
    */
-  void increment_constructor_count (const std::string& name);
+  void increment_constructor_count (const unsigned int type_id);
 
   /**
-   * Increments the destruction counter. Should be called in
-   * the destructor of any derived class that will be
-   * reference counted.
+   * Increments the destruction counter of the class with id
+   * \p type_id.  Should be called in the destructor of any derived
+   * class that will be reference counted.
    */
-  void increment_destructor_count (const std::string& name);
+  void increment_destructor_count (const unsigned int type_id);
 
   /**
-   * Data structure to log the information.  The log is
-   * identified by the class name.
+   * Increments the construction counter of the class \p name.  This
+   * looks the class up by name under a lock; prefer the id version.
    */
-  typedef std::map<std::string, std::pair<unsigned int,
-					  unsigned int> > Counts;
+  void increment_constructor_count (const std::string& name)
+  { this->increment_constructor_count (register_type(name)); }
 
   /**
-   * Actually holds the data.
+   * Increments the destruction counter of the class \p name.  This
+   * looks the class up by name under a lock; prefer the id version.
    */
-  static Counts _counts;
+  void increment_destructor_count (const std::string& name)
+  { this->increment_destructor_count (register_type(name)); }
 
 #endif
 
   /**
-   * The number of objects.  Print the reference count
-   * information when the number returns to 0.
+   * The counts made by one thread.
    */
-  static Threads::atomic<unsigned int> _n_objects;
+  struct ThreadCounts
+  {
+    ThreadCounts () : n_objects(0) {}
+
+    /**
+     * Objects constructed minus objects destroyed by this thread.
+     * This may be negative, since objects may be destroyed on another
+     * thread than the one they were constructed on.
+     */
+    long n_objects;
+
+#if defined(LIBMESH_ENABLE_REFERENCE_COUNTING) && defined(DEBUG)
+    /**
+     * The (creations, destructions) of each class, by id.
+     */
+    std::vector<std::pair<unsigned int, unsigned int> > counts;
+#endif
+  };
+
+  /**
+   * @returns the counts of the calling thread, creating them if
+   * needed.
+   */
+  static ThreadCounts & thread_counts ();
+
+  /**
+   * Without pthreads all threads share one \p ThreadCounts, which
+   * this locks \p _mutex to update.  With pthreads each thread has
+   * its own, and this does nothing.
+   */
+  class SharedCountsLock
+  {
+  public:
+#ifdef LIBMESH_HAVE_PTHREAD
+    explicit SharedCountsLock (Threads::spin_mutex &) {}
+#else
+    explicit SharedCountsLock (Threads::spin_mutex &m) : _lock(m) {}
+  private:
+    Threads::spin_mutex::scoped_lock _lock;
+#endif
+  };
 
   /**
    * Mutual exclusion object to enable thread-safe reference counting.
@@ -135,6 +199,40 @@ protected:
    * is printed when print_info is called.
    */
   static bool _enable_print_counter;
+
+private:
+
+  /**
+   * The counts of every running thread which has counted an object.
+   * The first entry holds the counts of threads which have exited,
+   * or without pthreads the counts of all threads.
+   */
+  static std::vector<ThreadCounts*> & all_thread_counts ();
+
+#ifdef LIBMESH_HAVE_PTHREAD
+  /**
+   * Creates the key under which each thread finds its counts.
+   */
+  static void create_thread_counts_key ();
+
+  /**
+   * Adds the counts \p tc of an exiting thread to those of the
+   * threads which have exited, and frees them.
+   */
+  static void retire_thread_counts (void *tc);
+#endif
+
+#if defined(LIBMESH_ENABLE_REFERENCE_COUNTING) && defined(DEBUG)
+  /**
+   * The name of each counted class, by id.
+   */
+  static std::vector<std::string> & type_names ();
+
+  /**
+   * The id of each counted class, by name.
+   */
+  static std::map<std::string, unsigned int> & type_ids ();
+#endif
 };
 
 
@@ -143,14 +241,24 @@ protected:
 // ReferenceCounter class inline methods
 inline ReferenceCounter::ReferenceCounter()
 {
-  _n_objects++;
+  SharedCountsLock shared_lock(_mutex);
+  thread_counts().n_objects++;
+}
+
+
+
+inline ReferenceCounter::ReferenceCounter(const ReferenceCounter&)
+{
+  SharedCountsLock shared_lock(_mutex);
+  thread_counts().n_objects++;
 }
 
 
 
 inline ReferenceCounter::~ReferenceCounter()
 {
-  _n_objects--;
+  SharedCountsLock shared_lock(_mutex);
+  thread_counts().n_objects--;
 }
 
 
@@ -160,12 +268,21 @@ inline ReferenceCounter::~ReferenceCounter()
 
 #if defined(LIBMESH_ENABLE_REFERENCE_COUNTING) && defined(DEBUG)
 inline
-void ReferenceCounter::increment_constructor_count (const std::string& name)
+void ReferenceCounter::increment_constructor_count (const unsigned int type_id)
 {
-  Threads::spin_mutex::scoped_lock lock(Threads::spin_mtx);
-  std::pair<unsigned int, unsigned int>& p = _counts[name];
+  SharedCountsLock shared_lock(_mutex);
+  ThreadCounts &tc = thread_counts();
+
+  // Growing the vector must not race with get_info() reading it
+  if (type_id >= tc.counts.size())
+    {
+#ifdef LIBMESH_HAVE_PTHREAD
+      Threads::spin_mutex::scoped_lock lock(_mutex);
+#endif
+      tc.counts.resize(type_id+1);
+    }
 
-  p.first++;
+  tc.counts[type_id].first++;
 }
 #endif
 
@@ -173,12 +290,20 @@ void ReferenceCounter::increment_constructor_count (const std::string& name)
 
 #if defined(LIBMESH_ENABLE_REFERENCE_COUNTING) && defined(DEBUG)
 inline
-void ReferenceCounter::increment_destructor_count (const std::string& name)
+void ReferenceCounter::increment_destructor_count (const unsigned int type_id)
 {
-  Threads::spin_mutex::scoped_lock lock(Threads::spin_mtx);
-  std::pair<unsigned int, unsigned int>& p = _counts[name];
+  SharedCountsLock shared_lock(_mutex);
+  ThreadCounts &tc = thread_counts();
+
+  if (type_id >= tc.counts.size())
+    {
+#ifdef LIBMESH_HAVE_PTHREAD
+      Threads::spin_mutex::scoped_lock lock(_mutex);
+#endif
+      tc.counts.resize(type_id+1);
+    }
 
-  p.second++;
+  tc.counts[type_id].second++;
 }
 #endif
 
@@ -106,6 +106,12 @@ namespace SparsityPattern // use a namespace so member classes can be forward-de
     void join (const Build &other);
 
     void parallel_sync ();
+
+    /**
+     * @returns an estimate of the number of bytes of memory used by
+     * the sparsity pattern and the nonzero counts.
+     */
+    std::size_t memory_usage () const;
   };
 
 #if defined(__GNUC__) && (__GNUC__ < 4) && !defined(__INTEL_COMPILER)
@@ -25,6 +25,7 @@
 #include "libmesh/dense_vector.h"
 #include "libmesh/error_estimator.h"
 #include "libmesh/fe_base.h"
+#include "libmesh/side_map_cache.h"
 
 // C++ includes
 #include <cstddef>
@@ -37,6 +38,7 @@ namespace libMesh
 // Forward Declarations
 class Point;
 class Elem;
+class QBase;
 
 
 
@@ -59,7 +61,9 @@ public:
     : ErrorEstimator(),
       scale_by_n_flux_faces(false),
       integrate_boundary_sides(false),
-      fe_fine(NULL), fe_coarse(NULL) {}
+      fe_fine(NULL), fe_coarse(NULL),
+      use_side_map_cache(true),
+      fine_qrule(NULL) {}
 
   /**
    * Destructor.
@@ -88,6 +92,15 @@ public:
    */
   bool scale_by_n_flux_faces;
 
+  /**
+   * If true, the fine side quadrature points are mapped onto a
+   * conforming coarse element by \p side_map_cache, rather than by
+   * inverting the coarse element's map.  Both give the same points,
+   * to within the inverse map tolerance.  The value is initialized
+   * to true.
+   */
+  bool use_side_map_cache;
+
 protected:
   /**
    * A utility function to reinit the finite element data on elements sharing a
@@ -156,6 +169,15 @@ protected:
    * The finite element objects for fine and coarse elements
    */
   AutoPtr<FEBase> fe_fine, fe_coarse;
+
+private:
+
+  /**
+   * The quadrature rule on the fine element sides, and its points
+   * mapped onto conforming coarse elements.
+   */
+  const QBase* fine_qrule;
+  SideMapCache side_map_cache;
 };
 
 
@@ -23,6 +23,7 @@
 // Local includes
 #include "libmesh/fe_base.h"
 #include "libmesh/libmesh.h"
+#include "libmesh/side_map_cache.h"
 
 // C++ includes
 #include <cstddef>
@@ -201,6 +202,51 @@ public:
 				        const unsigned int j,
 				        const Point& p);
 
+  /**
+   * Computes the values of all the shape functions at all the points
+   * \p p at once: \p v[i][q] is the value of the \f$ i^{th} \f$ shape
+   * function at point \p p[q].  \p v must already be sized to the
+   * number of shape functions, and each \p v[i] to the number of
+   * points.
+   *
+   * Families whose shape functions are tensor products (e.g.
+   * \p HIERARCHIC on quadrilaterals and hexahedra) evaluate each of
+   * their 1D factors only once per point; the others call \p shape()
+   * for each shape function and point.
+   *
+   * On a p-refined element, \p o should be the base order of the element.
+   */
+  static void shapes(const Elem* elem,
+		     const Order o,
+		     const std::vector<Point>& p,
+		     std::vector<std::vector<OutputShape> >& v);
+
+  /**
+   * Computes the \f$ j^{th} \f$ derivative of all the shape
+   * functions at all the points \p p at once, in the layout of
+   * \p shapes().
+   *
+   * On a p-refined element, \p o should be the base order of the element.
+   */
+  static void shape_derivs(const Elem* elem,
+			   const Order o,
+			   const unsigned int j,
+			   const std::vector<Point>& p,
+			   std::vector<std::vector<OutputShape> >& v);
+
+  /**
+   * Computes the \f$ j^{th} \f$ second derivative of all the shape
+   * functions at all the points \p p at once, in the layout of
+   * \p shapes().
+   *
+   * On a p-refined element, \p o should be the base order of the element.
+   */
+  static void shape_second_derivs(const Elem* elem,
+				  const Order o,
+				  const unsigned int j,
+				  const std::vector<Point>& p,
+				  std::vector<std::vector<OutputShape> >& v);
+
   /**
    * Build the nodal soln from the element soln.
    * This is the solution that will be plotted.
@@ -478,10 +524,56 @@ protected:
   ElemType last_side;
 
   unsigned int last_edge;
+
+  /**
+   * The reference side points mapped by \p side_map(), for reuse
+   * on sides of other elements with the same type and side.
+   */
+  SideMapCache side_map_cache;
 };
 
 
 
+// Tensor-product families with their own batched shape functions
+template <>
+void FE<2,HIERARCHIC>::shapes(const Elem*, const Order,
+                              const std::vector<Point>&,
+                              std::vector<std::vector<Real> >&);
+template <>
+void FE<2,HIERARCHIC>::shape_derivs(const Elem*, const Order,
+                                    const unsigned int,
+                                    const std::vector<Point>&,
+                                    std::vector<std::vector<Real> >&);
+template <>
+void FE<3,HIERARCHIC>::shapes(const Elem*, const Order,
+                              const std::vector<Point>&,
+                              std::vector<std::vector<Real> >&);
+template <>
+void FE<3,HIERARCHIC>::shape_derivs(const Elem*, const Order,
+                                    const unsigned int,
+                                    const std::vector<Point>&,
+                                    std::vector<std::vector<Real> >&);
+template <>
+void FE<2,LAGRANGE>::shapes(const Elem*, const Order,
+                            const std::vector<Point>&,
+                            std::vector<std::vector<Real> >&);
+template <>
+void FE<2,LAGRANGE>::shape_derivs(const Elem*, const Order,
+                                  const unsigned int,
+                                  const std::vector<Point>&,
+                                  std::vector<std::vector<Real> >&);
+template <>
+void FE<3,LAGRANGE>::shapes(const Elem*, const Order,
+                            const std::vector<Point>&,
+                            std::vector<std::vector<Real> >&);
+template <>
+void FE<3,LAGRANGE>::shape_derivs(const Elem*, const Order,
+                                  const unsigned int,
+                                  const std::vector<Point>&,
+                                  std::vector<std::vector<Real> >&);
+
+
+
 /**
  * Clough-Tocher finite elements.  Still templated on the dimension,
  * \p Dim.
@@ -443,6 +443,11 @@ public:
    */
   const FEMap& get_fe_map() const { return *_fe_map.get(); }
 
+  /**
+   * @returns a writeable reference to the mapping object
+   */
+  FEMap& get_fe_map() { return *_fe_map.get(); }
+
   /**
    * Prints the Jacobian times the weight for each quadrature point.
    */
@@ -0,0 +1,156 @@
+// The libMesh Finite Element Library.
+// Copyright (C) 2002-2012 Benjamin S. Kirk, John W. Peterson, Roy H. Stogner
+
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+
+
+#ifndef LIBMESH_FE_COEFFICIENT_CACHE_H
+#define LIBMESH_FE_COEFFICIENT_CACHE_H
+
+// Local includes
+#include "libmesh/elem.h"
+#include "libmesh/point.h"
+
+// C++ includes
+#include <vector>
+
+namespace libMesh
+{
+
+/**
+ * This class caches the per-element coefficients which finite element
+ * families like \p CLOUGH and \p HERMITE compute from the element
+ * geometry before evaluating their shape functions.  The coefficients
+ * of the last few elements are kept, so that alternating between an
+ * element and its neighbors (e.g. on sides) does not recompute them.
+ *
+ * An entry is reused only if the element has the same id, type and
+ * node locations as when it was computed, so moving the mesh or
+ * renumbering its elements is safe.
+ *
+ * The cache itself is not thread-safe; each thread should use its
+ * own, e.g. through \p LIBMESH_TLS_TYPE:
+ *
+ * \verbatim
+ * LIBMESH_TLS_TYPE(FECoefficientCache<MyCoefs>) my_cache;
+ * const MyCoefs &c = LIBMESH_TLS_REF(my_cache).get(elem, my_compute_coefs);
+ * \endverbatim
+ */
+template <typename Coefs>
+class FECoefficientCache
+{
+public:
+
+  /**
+   * The function computing the coefficients of an element.
+   */
+  typedef void (*compute_function)(const Elem*, Coefs&);
+
+  /**
+   * Constructor.  The cache is initially empty.
+   */
+  FECoefficientCache () : _next(0) {}
+
+  /**
+   * @returns the coefficients of \p elem, calling \p compute if they
+   * are not cached.  The reference is valid until the next call.
+   */
+  const Coefs & get (const Elem *elem, compute_function compute);
+
+private:
+
+  /**
+   * The coefficients of an element, and the element data they were
+   * computed from.
+   */
+  struct Entry
+  {
+    Entry () : id(DofObject::invalid_id), type(INVALID_ELEM) {}
+
+    dof_id_type id;
+    ElemType type;
+    std::vector<Point> points;
+    Coefs coefs;
+  };
+
+  /**
+   * @returns true if \p entry holds the coefficients of \p elem.
+   */
+  static bool matches (const Entry &entry, const Elem *elem);
+
+  /**
+   * The number of elements whose coefficients are kept.
+   */
+  static const unsigned int n_entries = 4;
+
+  Entry _entries[n_entries];
+
+  /**
+   * The entry to be replaced next.
+   */
+  unsigned int _next;
+};
+
+
+
+// ------------------------------------------------------------
+// FECoefficientCache inline methods
+template <typename Coefs>
+inline
+bool FECoefficientCache<Coefs>::matches (const Entry &entry,
+                                         const Elem *elem)
+{
+  if (entry.id != elem->id() ||
+      entry.type != elem->type())
+    return false;
+
+  for (unsigned int n=0; n != entry.points.size(); ++n)
+    if (entry.points[n] != elem->point(n))
+      return false;
+
+  return true;
+}
+
+
+
+template <typename Coefs>
+inline
+const Coefs & FECoefficientCache<Coefs>::get (const Elem *elem,
+                                              compute_function compute)
+{
+  libmesh_assert(elem);
+
+  for (unsigned int e=0; e != n_entries; ++e)
+    if (matches(_entries[e], elem))
+      return _entries[e].coefs;
+
+  Entry &entry = _entries[_next];
+  _next = (_next + 1) % n_entries;
+
+  entry.id = elem->id();
+  entry.type = elem->type();
+  entry.points.resize(elem->n_nodes());
+  for (unsigned int n=0; n != elem->n_nodes(); ++n)
+    entry.points[n] = elem->point(n);
+
+  compute (elem, entry.coefs);
+
+  return entry.coefs;
+}
+
+} // namespace libMesh
+
+#endif // LIBMESH_FE_COEFFICIENT_CACHE_H
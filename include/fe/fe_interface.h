@@ -280,6 +280,22 @@ public:
 		    const Point& p,
 		    OutputType& phi);
 
+  /**
+   * Computes the values of all the shape functions at all the points
+   * \p p at once, with \p v[i][q] the value of shape function \p i at
+   * \p p[q].  \p v must already be sized to the number of shape
+   * functions and points.  This is equivalent to calling \p shape()
+   * for each pair, but allows families to share work between them.
+   *
+   * On a p-refined element, \p fe_t.order should be the base order of the element.
+   */
+  template< typename OutputType>
+  static void shapes(const unsigned int dim,
+		     const FEType& fe_t,
+		     const Elem* elem,
+		     const std::vector<Point>& p,
+		     std::vector<std::vector<OutputType> >& v);
+
   /**
    * Lets the appropriate child of \p FEBase compute the requested
    * data for the input specified in \p data, and returns the values
@@ -32,6 +32,7 @@ namespace libMesh
 
 // forward declarations
 class Elem;
+class FEMapBatch;
 
   class FEMap
   {
@@ -74,6 +75,15 @@ class Elem;
                              const std::vector<Real>& qw,
                              const Elem* elem);
 
+    /**
+     * Tells the map to take the jacobians of the elements in
+     * \p batch from it, rather than computing them, in
+     * \p compute_map().  The batch must outlive its use here; pass
+     * NULL to stop using it.
+     */
+    void set_batch(const FEMapBatch* batch)
+    { _batch = batch; }
+
     /**
      * Same as compute_map, but for a side.  Useful for boundary integration.
      */
@@ -429,6 +439,15 @@ class Elem;
      */
     void resize_quadrature_map_vectors(const unsigned int dim, unsigned int n_qp);
 
+    /**
+     * Compute the map data of \p elem, which is element \p e of the
+     * batch, from the batch's precomputed jacobians.
+     */
+    void compute_batch_map(const unsigned int dim,
+                           const std::vector<Real>& qw,
+                           const Elem* elem,
+                           const unsigned int e);
+
     /**
      * Used in \p FEMap::compute_map(), which should be
      * be usable in derived classes, and therefore protected.
@@ -729,6 +748,11 @@ class Elem;
      * Jacobian*Weight values at quadrature points
      */
     std::vector<Real> JxW;
+
+    /**
+     * Precomputed jacobians for a block of affine elements, or NULL.
+     */
+    const FEMapBatch* _batch;
   };
 
 }
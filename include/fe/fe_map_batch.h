@@ -0,0 +1,151 @@
+// The libMesh Finite Element Library.
+// Copyright (C) 2002-2012 Benjamin S. Kirk, John W. Peterson, Roy H. Stogner
+
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+
+
+#ifndef LIBMESH_FE_MAP_BATCH_H
+#define LIBMESH_FE_MAP_BATCH_H
+
+// Local includes
+#include "libmesh/libmesh_common.h"
+#include "libmesh/enum_elem_type.h"
+
+// C++ includes
+#include <vector>
+
+namespace libMesh
+{
+
+// forward declarations
+class Elem;
+
+/**
+ * This class computes the Jacobians, inverse Jacobians and Jacobian
+ * determinants of the maps of a block of affine elements of a single
+ * type at once.  Since the map of an affine element is constant, it
+ * is determined by the vertices of the element and the derivatives
+ * of the first order shape functions, which are shared by the whole
+ * block.
+ *
+ * The data is stored in structure of arrays layout: each entry of
+ * the Jacobian (and of its inverse) is a contiguous array over the
+ * elements of the block, so that every step of the computation is a
+ * loop over elements which the compiler can vectorize.
+ *
+ * An \p FEMap which is given a batch with \p FEMap::set_batch() uses
+ * its data for the elements in the batch instead of computing their
+ * map.
+ */
+class FEMapBatch
+{
+public:
+
+  /**
+   * Constructor.  The batch is empty until \p reinit() is called.
+   */
+  FEMapBatch ();
+
+  /**
+   * Computes the maps of \p elems, which must be affine elements of a
+   * single type.
+   */
+  void reinit (const std::vector<const Elem*>& elems);
+
+  /**
+   * @returns the number of elements in the batch.
+   */
+  unsigned int n_elem () const
+  { return libmesh_cast_int<unsigned int>(_elems.size()); }
+
+  /**
+   * @returns the dimension of the elements in the batch.
+   */
+  unsigned int dim () const { return _dim; }
+
+  /**
+   * @returns the index of \p elem in the batch, or \p invalid_uint
+   * if it is not in the batch.  Lookups of the elements in batch
+   * order are constant time.
+   */
+  unsigned int index (const Elem* elem) const;
+
+  /**
+   * @returns the derivative of physical coordinate \p c with respect
+   * to reference coordinate \p i on element \p e of the batch.
+   */
+  Real dxyzdxi (unsigned int e, unsigned int i, unsigned int c) const
+  { return _dxyzdxi[(i*LIBMESH_DIM + c)*_elems.size() + e]; }
+
+  /**
+   * @returns the derivative of reference coordinate \p i with respect
+   * to physical coordinate \p c on element \p e of the batch.
+   */
+  Real dxidx (unsigned int e, unsigned int i, unsigned int c) const
+  { return _dxidx[(i*LIBMESH_DIM + c)*_elems.size() + e]; }
+
+  /**
+   * @returns the (generalized) Jacobian determinant of element \p e
+   * of the batch.
+   */
+  Real jac (unsigned int e) const
+  { return _jac[e]; }
+
+private:
+
+  /**
+   * The elements in the batch, and their type and dimension.
+   */
+  std::vector<const Elem*> _elems;
+  ElemType _type;
+  unsigned int _dim;
+
+  /**
+   * The index last returned by \p index().
+   */
+  mutable unsigned int _last_index;
+
+  /**
+   * The derivatives of the first order shape functions, which are
+   * constant on affine elements.  Entry \p i*n_vertices+v is the
+   * derivative of shape function \p v with respect to reference
+   * coordinate \p i.
+   */
+  std::vector<Real> _dphi;
+
+  /**
+   * The vertex coordinates; entry \p (c*n_vertices+v)*n_elem+e is
+   * coordinate \p c of vertex \p v of element \p e.
+   */
+  std::vector<Real> _vertices;
+
+  /**
+   * The Jacobians and their inverses; entry \p (i*LIBMESH_DIM+c)*n_elem+e
+   * is the entry for reference coordinate \p i and physical coordinate
+   * \p c of element \p e.
+   */
+  std::vector<Real> _dxyzdxi;
+  std::vector<Real> _dxidx;
+
+  /**
+   * The Jacobian determinants.
+   */
+  std::vector<Real> _jac;
+};
+
+} // namespace libMesh
+
+#endif // LIBMESH_FE_MAP_BATCH_H
@@ -0,0 +1,104 @@
+// The libMesh Finite Element Library.
+// Copyright (C) 2002-2012 Benjamin S. Kirk, John W. Peterson, Roy H. Stogner
+
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+
+
+#ifndef LIBMESH_SIDE_MAP_CACHE_H
+#define LIBMESH_SIDE_MAP_CACHE_H
+
+// Local includes
+#include "libmesh/libmesh_common.h"
+#include "libmesh/enum_elem_type.h"
+#include "libmesh/point.h"
+
+// C++ includes
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace libMesh
+{
+
+// forward declarations
+class Elem;
+
+/**
+ * This class maps points given in the reference coordinates of a side
+ * to the reference coordinates of an element containing that side,
+ * by interpolating the reference coordinates of the element nodes on
+ * the side, as \p FE::side_map() does.  This is exact, with no Newton
+ * iteration, when the side's map agrees with the element's map on
+ * that side: when the side was built from the element itself, or from
+ * a conforming neighbor of the same type.
+ *
+ * The result only depends on the type of the element, the local
+ * numbers in the element of the side's nodes, and the side points,
+ * so it is cached by the former and reused for as long as the side
+ * points (usually the points of a side quadrature rule) are
+ * unchanged.
+ */
+class SideMapCache
+{
+public:
+
+  /**
+   * Sets \p reference_points to the reference coordinates on \p elem
+   * of the points \p side_points, which are given in the reference
+   * coordinates of \p side.  @returns false, leaving \p
+   * reference_points unchanged, if some node of \p side is not a node
+   * of \p elem.
+   */
+  bool map (const Elem* elem,
+            const Elem* side,
+            const std::vector<Point>& side_points,
+            std::vector<Point>& reference_points);
+
+  /**
+   * Empties the cache.
+   */
+  void clear () { _cache.clear(); }
+
+private:
+
+  /**
+   * The cache key: the element type, the side type and the local
+   * numbers in the element of the side's nodes.
+   */
+  typedef std::pair<std::pair<ElemType, ElemType>,
+                    std::vector<unsigned int> > Key;
+
+  /**
+   * The side points of the last map with a key, and their reference
+   * coordinates.
+   */
+  struct Entry
+  {
+    std::vector<Point> side_points;
+    std::vector<Point> reference_points;
+  };
+
+  std::map<Key, Entry> _cache;
+
+  /**
+   * Scratch space for the key, to avoid reallocating it.
+   */
+  Key _key;
+};
+
+} // namespace libMesh
+
+#endif // LIBMESH_SIDE_MAP_CACHE_H
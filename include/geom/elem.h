@@ -658,6 +658,13 @@ public:
    */
   std::string get_info () const;
 
+  /**
+   * @returns an estimate of the number of bytes of memory used by
+   * the element: the object itself, its node and neighbor links,
+   * its array of children and its degree of freedom indexing.
+   */
+  std::size_t memory_usage () const;
+
   /**
    * @returns \p true if the element is active (i.e. has no active
    * descendants), \p false  otherwise. Note that it suffices to check the
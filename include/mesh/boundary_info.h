@@ -432,6 +432,12 @@ public:
    */
   void print_summary (std::ostream& out=libMesh::out) const;
 
+  /**
+   * @returns an estimate of the number of bytes of memory used by
+   * the boundary information on this processor.
+   */
+  std::size_t memory_usage () const;
+
   /**
    * Returns a writable reference for getting/setting an optional
    * name for a sideset name.
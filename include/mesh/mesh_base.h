@@ -589,6 +589,15 @@ public:
    */
   void print_info (std::ostream& os=libMesh::out) const;
 
+  /**
+   * @returns an estimate of the number of bytes of memory used by
+   * the mesh on this processor: its elements and nodes, the
+   * \p BoundaryInfo and the point locator, if one has been built.
+   * Derived classes add the containers which hold the elements and
+   * nodes.
+   */
+  virtual std::size_t memory_usage () const;
+
   /**
    * Equivalent to calling print_info() above, but now you can write:
    * Mesh mesh;
@@ -98,6 +98,13 @@ class ParallelMesh : public UnstructuredMesh
    */
   virtual void clear();
 
+  /**
+   * @returns an estimate of the number of bytes of memory used by
+   * the mesh on this processor, including the maps of element and
+   * node pointers.
+   */
+  virtual std::size_t memory_usage () const;
+
   /**
    * Redistribute elements between processors.  This gets called
    * automatically by the Partitioner, and is a no-op in the case of a
@@ -101,6 +101,12 @@ class SerialMesh : public UnstructuredMesh
    */
   virtual void renumber_nodes_and_elements ();
 
+  /**
+   * @returns an estimate of the number of bytes of memory used by
+   * the mesh, including the arrays of element and node pointers.
+   */
+  virtual std::size_t memory_usage () const;
+
   virtual dof_id_type n_nodes () const
   { return libmesh_cast_int<dof_id_type>(_nodes.size()); }
 
@@ -0,0 +1,292 @@
+// The libMesh Finite Element Library.
+// Copyright (C) 2002-2012 Benjamin S. Kirk, John W. Peterson, Roy H. Stogner
+
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+
+
+#ifndef LIBMESH_DUAL_NUMBER_H
+#define LIBMESH_DUAL_NUMBER_H
+
+// Local includes
+#include "libmesh/libmesh_common.h"
+#include "libmesh/compare_types.h"
+
+// C++ includes
+#include <cmath>
+#include <ostream>
+
+namespace libMesh
+{
+
+/**
+ * This class is a dual number for forward mode automatic
+ * differentiation: a value of type \p T together with its derivatives
+ * with respect to \p N independent variables.  The derivatives are
+ * stored in a fixed size array, so that the arithmetic on them is a
+ * loop of known length which the compiler can vectorize.
+ *
+ * The arithmetic operators and the functions \p sqrt, \p exp, \p log,
+ * \p pow, \p sin, \p cos, \p tan and \p abs apply the chain rule.  The
+ * functions are only found by argument dependent lookup, so they should
+ * be called unqualified (\p sqrt(u) rather than \p std::sqrt(u)) in
+ * code templated on the scalar type.  Comparisons compare values only.
+ */
+template <typename T, unsigned int N>
+class DualNumber
+{
+public:
+
+  /**
+   * Constructor.  A constant: the value \p val with zero derivatives.
+   * Non-explicit, so that constants mix with dual numbers.
+   */
+  DualNumber (const T val = 0.);
+
+  /**
+   * @returns the value.
+   */
+  const T& value () const { return _val; }
+
+  /**
+   * @returns a writeable reference to the value.
+   */
+  T& value () { return _val; }
+
+  /**
+   * @returns the derivative with respect to the \p i th variable.
+   */
+  const T& derivative (const unsigned int i) const
+  { libmesh_assert_less (i, N); return _deriv[i]; }
+
+  /**
+   * @returns a writeable reference to the derivative with respect to
+   * the \p i th variable.
+   */
+  T& derivative (const unsigned int i)
+  { libmesh_assert_less (i, N); return _deriv[i]; }
+
+  /**
+   * Compound arithmetic with other dual numbers and constants.
+   */
+  DualNumber& operator += (const DualNumber& b);
+  DualNumber& operator -= (const DualNumber& b);
+  DualNumber& operator *= (const DualNumber& b);
+  DualNumber& operator /= (const DualNumber& b);
+  DualNumber& operator += (const T& b) { _val += b; return *this; }
+  DualNumber& operator -= (const T& b) { _val -= b; return *this; }
+  DualNumber& operator *= (const T& b);
+  DualNumber& operator /= (const T& b) { return *this *= (T(1.)/b); }
+
+  DualNumber operator - () const
+  { DualNumber r(*this); r *= T(-1.); return r; }
+
+  /**
+   * Arithmetic.  These are friends defined in the class, so that
+   * constants of any type convertible to \p T mix with dual numbers.
+   */
+  friend DualNumber operator + (DualNumber a, const DualNumber& b) { return a += b; }
+  friend DualNumber operator + (DualNumber a, const T& b) { return a += b; }
+  friend DualNumber operator + (const T& a, DualNumber b) { return b += a; }
+  friend DualNumber operator - (DualNumber a, const DualNumber& b) { return a -= b; }
+  friend DualNumber operator - (DualNumber a, const T& b) { return a -= b; }
+  friend DualNumber operator - (const T& a, const DualNumber& b) { return -b + a; }
+  friend DualNumber operator * (DualNumber a, const DualNumber& b) { return a *= b; }
+  friend DualNumber operator * (DualNumber a, const T& b) { return a *= b; }
+  friend DualNumber operator * (const T& a, DualNumber b) { return b *= a; }
+  friend DualNumber operator / (DualNumber a, const DualNumber& b) { return a /= b; }
+  friend DualNumber operator / (DualNumber a, const T& b) { return a /= b; }
+  friend DualNumber operator / (const T& a, const DualNumber& b) { return DualNumber(a) /= b; }
+
+  /**
+   * Comparisons, of the values only.
+   */
+  friend bool operator <  (const DualNumber& a, const DualNumber& b) { return a._val <  b._val; }
+  friend bool operator >  (const DualNumber& a, const DualNumber& b) { return a._val >  b._val; }
+  friend bool operator <= (const DualNumber& a, const DualNumber& b) { return a._val <= b._val; }
+  friend bool operator >= (const DualNumber& a, const DualNumber& b) { return a._val >= b._val; }
+  friend bool operator == (const DualNumber& a, const DualNumber& b) { return a._val == b._val; }
+  friend bool operator != (const DualNumber& a, const DualNumber& b) { return a._val != b._val; }
+
+  /**
+   * Math functions.  Each one evaluates f(a) and scales the
+   * derivatives of \p a by f'(a).  Being friends defined in the class
+   * they are only found by argument dependent lookup, and do not hide
+   * the functions of the same name for other types.
+   */
+#define LIBMESH_DUAL_NUMBER_FUNCTION(name, f, df)       \
+  friend DualNumber name (const DualNumber& a)          \
+  {                                                     \
+    using std::name;                                    \
+    const T x = a._val;                                 \
+    DualNumber r = a;                                   \
+    r *= T(df);                                         \
+    r._val = f;                                         \
+    return r;                                           \
+  }
+
+  LIBMESH_DUAL_NUMBER_FUNCTION(sqrt, sqrt(x), 0.5/sqrt(x))
+  LIBMESH_DUAL_NUMBER_FUNCTION(exp,  exp(x),  exp(x))
+  LIBMESH_DUAL_NUMBER_FUNCTION(log,  log(x),  1./x)
+  LIBMESH_DUAL_NUMBER_FUNCTION(sin,  sin(x),  cos(x))
+  LIBMESH_DUAL_NUMBER_FUNCTION(cos,  cos(x),  -sin(x))
+  LIBMESH_DUAL_NUMBER_FUNCTION(tan,  tan(x),  1./(cos(x)*cos(x)))
+  LIBMESH_DUAL_NUMBER_FUNCTION(abs,  abs(x),  (x < 0 ? -1. : 1.))
+
+#undef LIBMESH_DUAL_NUMBER_FUNCTION
+
+  friend DualNumber pow (const DualNumber& a, const T& b)
+  {
+    using std::pow;
+    DualNumber r = a;
+    r *= b * pow(a._val, b - T(1.));
+    r._val = pow(a._val, b);
+    return r;
+  }
+
+  friend std::ostream& operator << (std::ostream& os, const DualNumber& a)
+  {
+    os << a._val << " (";
+    for (unsigned int i=0; i != N; ++i)
+      os << (i ? ", " : "") << a._deriv[i];
+    return os << ')';
+  }
+
+private:
+
+  /**
+   * Sets the derivatives to \p a times the derivatives of \p b, plus
+   * \p c times our own.  The chain rule for every operation.
+   */
+  void chain (const T& a, const DualNumber& b, const T& c);
+
+  T _val;
+
+  T _deriv[N];
+};
+
+
+
+// ------------------------------------------------------------
+// DualNumber inline methods
+
+template <typename T, unsigned int N>
+inline
+DualNumber<T,N>::DualNumber (const T val) :
+  _val(val)
+{
+  for (unsigned int i=0; i != N; ++i)
+    _deriv[i] = 0.;
+}
+
+
+
+template <typename T, unsigned int N>
+inline
+void DualNumber<T,N>::chain (const T& a, const DualNumber& b, const T& c)
+{
+  for (unsigned int i=0; i != N; ++i)
+    _deriv[i] = a * b._deriv[i] + c * _deriv[i];
+}
+
+
+
+template <typename T, unsigned int N>
+inline
+DualNumber<T,N>& DualNumber<T,N>::operator += (const DualNumber& b)
+{
+  _val += b._val;
+  for (unsigned int i=0; i != N; ++i)
+    _deriv[i] += b._deriv[i];
+  return *this;
+}
+
+
+
+template <typename T, unsigned int N>
+inline
+DualNumber<T,N>& DualNumber<T,N>::operator -= (const DualNumber& b)
+{
+  _val -= b._val;
+  for (unsigned int i=0; i != N; ++i)
+    _deriv[i] -= b._deriv[i];
+  return *this;
+}
+
+
+
+template <typename T, unsigned int N>
+inline
+DualNumber<T,N>& DualNumber<T,N>::operator *= (const DualNumber& b)
+{
+  // (ab)' = a b' + b a'
+  this->chain (_val, b, b._val);
+  _val *= b._val;
+  return *this;
+}
+
+
+
+template <typename T, unsigned int N>
+inline
+DualNumber<T,N>& DualNumber<T,N>::operator /= (const DualNumber& b)
+{
+  // (a/b)' = a'/b - a b'/b^2
+  const T inv_b = T(1.) / b._val;
+  _val *= inv_b;
+  this->chain (-_val * inv_b, b, inv_b);
+  return *this;
+}
+
+
+
+template <typename T, unsigned int N>
+inline
+DualNumber<T,N>& DualNumber<T,N>::operator *= (const T& b)
+{
+  _val *= b;
+  for (unsigned int i=0; i != N; ++i)
+    _deriv[i] *= b;
+  return *this;
+}
+
+
+
+// ------------------------------------------------------------
+// Type traits, so that dual numbers can be the entries of a
+// TypeVector or TypeTensor
+
+template <typename T, unsigned int N>
+struct ScalarTraits<DualNumber<T,N> > { static const bool value = ScalarTraits<T>::value; };
+
+template <typename T, unsigned int N, typename T2>
+struct CompareTypes<DualNumber<T,N>, T2> {
+  typedef DualNumber<typename CompareTypes<T,T2>::supertype, N> supertype;
+};
+
+template <typename T, unsigned int N, typename T2>
+struct CompareTypes<T2, DualNumber<T,N> > {
+  typedef DualNumber<typename CompareTypes<T,T2>::supertype, N> supertype;
+};
+
+template <typename T, unsigned int N>
+struct CompareTypes<DualNumber<T,N>, DualNumber<T,N> > {
+  typedef DualNumber<T,N> supertype;
+};
+
+} // namespace libMesh
+
+
+#endif // LIBMESH_DUAL_NUMBER_H
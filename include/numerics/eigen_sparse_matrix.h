@@ -246,6 +246,12 @@ public:
    */
   bool closed() const { return _closed; }
 
+  /**
+   * @returns an estimate of the number of bytes of memory used by
+   * the matrix on this processor.
+   */
+  std::size_t memory_usage () const;
+
   /**
    * Print the contents of the matrix, by default to libMesh::out.
    * Currently identical to \p print().
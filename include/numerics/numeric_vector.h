@@ -317,6 +317,14 @@ public:
    */
   virtual numeric_index_type local_size() const = 0;
 
+  /**
+   * @returns an estimate of the number of bytes of memory used by
+   * the vector on this processor.  The default implementation
+   * counts the locally stored entries; derived classes which store
+   * ghost entries should add them.
+   */
+  virtual std::size_t memory_usage () const;
+
   /**
    * @returns the index of the first vector element
    * actually stored on this processor.  Hint: the
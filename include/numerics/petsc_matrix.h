@@ -321,6 +321,12 @@ public:
    */
   bool closed() const;
 
+  /**
+   * @returns an estimate of the number of bytes of memory used by
+   * the matrix on this processor.
+   */
+  std::size_t memory_usage () const;
+
   /**
    * Print the contents of the matrix to the screen
    * with the PETSc viewer.  This function only allows
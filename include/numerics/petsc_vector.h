@@ -29,6 +29,7 @@
 // Local includes
 #include "libmesh/numeric_vector.h"
 #include "libmesh/petsc_macro.h"
+#include "libmesh/utility.h"
 
 /**
  * Petsc include files.
@@ -270,6 +271,12 @@ public:
    */
   numeric_index_type local_size() const;
 
+  /**
+   * @returns an estimate of the number of bytes of memory used by
+   * the vector on this processor, including any ghost entries.
+   */
+  virtual std::size_t memory_usage () const;
+
   /**
    * @returns the index of the first vector element
    * actually stored on this processor
@@ -1097,6 +1104,22 @@ numeric_index_type PetscVector<T>::size () const
 
 
 
+template <typename T>
+inline
+std::size_t PetscVector<T>::memory_usage () const
+{
+  if (!this->initialized())
+    return 0;
+
+  // Ghost entries are stored after the local entries and are
+  // located through the global to local map
+  return NumericVector<T>::memory_usage() +
+    _global_to_local_map.size() * sizeof(T) +
+    Utility::tree_memory_usage(_global_to_local_map);
+}
+
+
+
 template <typename T>
 inline
 numeric_index_type PetscVector<T>::local_size () const
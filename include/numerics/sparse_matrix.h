@@ -307,6 +307,13 @@ public:
    */
   virtual bool closed() const = 0;
 
+  /**
+   * @returns an estimate of the number of bytes of memory used by
+   * the matrix on this processor, or 0 if the underlying solver
+   * package does not let us make one.
+   */
+  virtual std::size_t memory_usage () const { return 0; }
+
   /**
    * Print the contents of the matrix to the screen
    * in a uniform style, regardless of matrix/solver
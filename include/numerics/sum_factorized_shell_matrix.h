@@ -0,0 +1,242 @@
+// The libMesh Finite Element Library.
+// Copyright (C) 2002-2012 Benjamin S. Kirk, John W. Peterson, Roy H. Stogner
+
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+
+
+#ifndef LIBMESH_SUM_FACTORIZED_SHELL_MATRIX_H
+#define LIBMESH_SUM_FACTORIZED_SHELL_MATRIX_H
+
+
+// Local includes
+#include "libmesh/libmesh_common.h"
+#include "libmesh/dense_matrix.h"
+#include "libmesh/enum_order.h"
+#include "libmesh/fe_base.h"
+#include "libmesh/id_types.h"
+#include "libmesh/shell_matrix.h"
+
+// C++ includes
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace libMesh
+{
+
+// Forward declarations
+class Elem;
+class System;
+
+
+/**
+ * This class applies the operator
+ *
+ * \f[ \int_\Omega a \nabla u \cdot \nabla v + b u v \f]
+ *
+ * of one variable of a \p System, with constant coefficients \p a and
+ * \p b, without storing its matrix.
+ *
+ * On elements where the shape functions of the variable are tensor
+ * products of 1D shape functions (\p LAGRANGE and \p HIERARCHIC
+ * families on \p EDGE, \p QUAD4, \p QUAD9, \p HEX8 and \p HEX27
+ * elements, including p-refined ones) the operator is applied by sum
+ * factorization: the 1D shape functions and their derivatives are
+ * tabulated once at the points of a 1D \p QGauss rule, and the
+ * element operator is applied one direction at a time.  This costs
+ * \f$ O(p^{d+1}) \f$ per element rather than the \f$ O(p^{2d}) \f$ of
+ * an element matrix, and only the geometric factors at the quadrature
+ * points are stored.  Other elements store their element matrix.
+ *
+ * The geometric factors are computed when the matrix is constructed,
+ * so \p init() must be called again if the mesh or its degrees of
+ * freedom change.  Degree of freedom constraints are not applied, as
+ * for any \p ShellMatrix.
+ *
+ * The matrix can be attached to a \p LinearImplicitSystem with \p
+ * attach_shell_matrix(), for solvers that support shell matrices.
+ */
+
+template <typename T>
+class SumFactorizedShellMatrix : public ShellMatrix<T>
+{
+public:
+  /**
+   * Constructor; takes a reference to the system, which has to be
+   * stored elsewhere, and the number of the variable the operator
+   * acts on.
+   */
+  SumFactorizedShellMatrix (const System& system,
+			    const unsigned int var,
+			    const Real stiffness_coefficient = 1.,
+			    const Real mass_coefficient = 0.);
+
+  /**
+   * Destructor.
+   */
+  virtual ~SumFactorizedShellMatrix ();
+
+  /**
+   * Computes the geometric factors (or element matrices) of the
+   * active local elements.  Called by the constructor.
+   */
+  void init ();
+
+  /**
+   * @returns \p m, the row-dimension of the matrix where the marix is
+   * \f$ M \times N \f$.
+   */
+  virtual numeric_index_type m () const;
+
+  /**
+   * @returns \p n, the column-dimension of the matrix where the marix
+   * is \f$ M \times N \f$.
+   */
+  virtual numeric_index_type n () const;
+
+  /**
+   * Multiplies the matrix with \p arg and stores the result in \p
+   * dest.
+   */
+  virtual void vector_mult (NumericVector<T>& dest,
+			    const NumericVector<T>& arg) const;
+
+  /**
+   * Multiplies the matrix with \p arg and adds the result to \p dest.
+   */
+  virtual void vector_mult_add (NumericVector<T>& dest,
+				const NumericVector<T>& arg) const;
+
+  /**
+   * Copies the diagonal part of the matrix into \p dest.
+   */
+  virtual void get_diagonal (NumericVector<T>& dest) const;
+
+  /**
+   * @returns the number of local elements which are applied by sum
+   * factorization, rather than with a stored element matrix.
+   */
+  unsigned int n_sum_factorized_elem () const
+  { return libmesh_cast_int<unsigned int>(_tensor_elems.size()); }
+
+private:
+
+  /**
+   * The 1D shape functions of one order and their derivatives, at the
+   * points of a 1D quadrature rule.  Entry \p k*n_points+q is shape
+   * function \p k at point \p q.
+   */
+  struct ShapeTable1D
+  {
+    unsigned int n_shapes, n_points;
+    std::vector<Real> points, weights;
+    std::vector<Real> phi, dphi;
+  };
+
+  /**
+   * An element applied by sum factorization.  Shape function \p i
+   * is \p scale[i] times the tensor product of the 1D shape functions
+   * \p tensor_index[i] (numbered with the first direction fastest).
+   * \p metric holds, at each quadrature point (also numbered with the
+   * first direction fastest), JxW times the dim x dim matrix of dot
+   * products of the reference coordinate gradients, followed by JxW.
+   */
+  struct TensorElem
+  {
+    std::vector<dof_id_type> dof_indices;
+    std::vector<unsigned int> tensor_index;
+    std::vector<Real> scale;
+    const ShapeTable1D *table;
+    std::vector<Real> metric;
+  };
+
+  /**
+   * An element applied with its element matrix.
+   */
+  struct DenseElem
+  {
+    std::vector<dof_id_type> dof_indices;
+    DenseMatrix<T> matrix;
+  };
+
+  /**
+   * Tries to set up \p elem for sum factorization, using \p fe to
+   * evaluate its shape functions and map.  @returns false if
+   * its shape functions are not tensor products.
+   */
+  bool init_tensor_elem (FEBase& fe,
+			 const Elem* elem,
+			 const std::vector<dof_id_type>& dof_indices);
+
+  /**
+   * Computes the element matrix of \p elem, with \p fe which has a
+   * quadrature rule attached.
+   */
+  void init_dense_elem (FEBase& fe,
+			const Elem* elem,
+			const std::vector<dof_id_type>& dof_indices);
+
+  /**
+   * @returns the 1D shape functions of order \p order at the points
+   * of the 1D \p QGauss rule of order \p q_order.
+   */
+  const ShapeTable1D & shape_table (const Order order,
+				    const Order q_order);
+
+  /**
+   * Adds the element operator of \p elem applied to \p u (in tensor
+   * numbering) to \p r.
+   */
+  void apply_tensor_elem (const TensorElem& elem,
+			  const std::vector<T>& u,
+			  std::vector<T>& r) const;
+
+  /**
+   * The system, its variable and the dimension of the mesh.
+   */
+  const System& _system;
+  const unsigned int _var;
+  const unsigned int _dim;
+
+  /**
+   * The operator coefficients.
+   */
+  const Real _stiffness_coefficient;
+  const Real _mass_coefficient;
+
+  /**
+   * The 1D shape tables, by shape function order and quadrature order.
+   */
+  std::map<std::pair<Order, Order>, ShapeTable1D> _shape_tables;
+
+  std::vector<TensorElem> _tensor_elems;
+  std::vector<DenseElem> _dense_elems;
+};
+
+
+
+//-----------------------------------------------------------------------
+// SumFactorizedShellMatrix inline members
+template <typename T>
+inline
+SumFactorizedShellMatrix<T>::~SumFactorizedShellMatrix ()
+{}
+
+
+} // namespace libMesh
+
+
+#endif // LIBMESH_SUM_FACTORIZED_SHELL_MATRIX_H
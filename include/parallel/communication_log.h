@@ -0,0 +1,199 @@
+// The libMesh Finite Element Library.
+// Copyright (C) 2002-2012 Benjamin S. Kirk, John W. Peterson, Roy H. Stogner
+
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+
+#ifndef LIBMESH_COMMUNICATION_LOG_H
+#define LIBMESH_COMMUNICATION_LOG_H
+
+// Local includes
+#include "libmesh/libmesh_common.h"
+#include "libmesh/perf_log.h"
+
+// C++ includes
+#include <cstddef>
+#include <map>
+#include <string>
+#include <utility>
+
+namespace libMesh
+{
+
+namespace Parallel
+{
+
+// Forward Declarations
+class Communicator;
+
+/**
+ * The \p CommunicationLog optionally counts the calls, bytes sent
+ * and time spent in each type of operation done through a
+ * \p Parallel::Communicator.  The counts are kept both in total and
+ * for each \p PerfLog event they occur in.  Each operation is
+ * charged to the innermost event running at the time which is not
+ * itself one of the "Parallel" events.
+ *
+ * Logging is off by default; if it is off, each operation costs one
+ * flag test.  Like the rest of \p Parallel::, the log is not
+ * thread-safe, so communication should only be done by one thread
+ * at a time.
+ *
+ * Bytes are counted once, by the processor which sends them: a send
+ * counts the bytes sent, a collective operation the bytes this
+ * processor contributes to it (only the root's, for a broadcast),
+ * and a receive counts no bytes.  Packed range operations are
+ * counted both as such and as the underlying operations that carry
+ * them.
+ */
+
+// ------------------------------------------------------------
+// CommunicationLog class definition
+class CommunicationLog
+{
+public:
+
+  /**
+   * The types of operation which are counted.
+   */
+  enum Operation { SEND = 0,
+                   RECEIVE,
+                   BROADCAST,
+                   GATHER,
+                   ALLGATHER,
+                   ALLTOALL,
+                   SUM,
+                   MIN_MAX,
+                   BARRIER,
+                   WAIT,
+                   PACKED_RANGE,
+                   N_OPERATIONS };
+
+  /**
+   * Starts counting communication.
+   */
+  static void enable () { _enabled = true; }
+
+  /**
+   * Stops counting communication.
+   */
+  static void disable () { _enabled = false; }
+
+  /**
+   * Returns true iff communication is being counted.
+   */
+  static bool enabled () { return _enabled; }
+
+  /**
+   * Discards all counts.
+   */
+  static void clear ();
+
+  /**
+   * Counts one operation of type \p op which moved \p bytes and
+   * took \p time seconds.
+   */
+  static void record (const Operation op,
+                      const std::size_t bytes,
+                      const double time);
+
+  /**
+   * @returns a string with the minimum, average and maximum over the
+   * processors of \p comm of the counts of each type of operation,
+   * followed by the counts of this processor for each \p PerfLog
+   * event.  This function must be called by all processors in
+   * \p comm.
+   */
+  static std::string get_summary (const Communicator &comm);
+
+  /**
+   * Prints the summary.  This function must be called by all
+   * processors in \p comm.
+   */
+  static void print_summary (const Communicator &comm);
+
+  /**
+   * @returns the name of the operation type \p op.
+   */
+  static const char * operation_name (const Operation op);
+
+  /**
+   * The \p Sentry records one operation when it goes out of scope,
+   * with the time since it was constructed.
+   */
+  class Sentry
+  {
+  public:
+    Sentry (const Operation op,
+            const std::size_t bytes) :
+      _op(op),
+      _bytes(bytes),
+      _active(CommunicationLog::enabled()),
+      _start(_active ? PerfData::wall_time() : 0.)
+    {}
+
+    ~Sentry ()
+    {
+      if (_active)
+        CommunicationLog::record (_op, _bytes,
+                                  PerfData::wall_time() - _start);
+    }
+
+    /**
+     * Adds \p bytes to the size of the operation, for operations
+     * whose size is only known once they have begun.
+     */
+    void add_bytes (const std::size_t bytes) { _bytes += bytes; }
+
+  private:
+    const Operation _op;
+    std::size_t _bytes;
+    const bool _active;
+    const double _start;
+  };
+
+private:
+
+  /**
+   * The counts for one type of operation.
+   */
+  struct Counts
+  {
+    Counts () : calls(0.), bytes(0.), time(0.) {}
+
+    double calls, bytes, time;
+  };
+
+  /**
+   * Whether communication is being counted.
+   */
+  static bool _enabled;
+
+  /**
+   * The counts for each type of operation.
+   */
+  static Counts _totals[N_OPERATIONS];
+
+  /**
+   * The counts for each (\p PerfLog event id, operation type) pair.
+   */
+  static std::map<std::pair<unsigned int, unsigned int>, Counts> _event_counts;
+};
+
+} // namespace Parallel
+
+} // namespace libMesh
+
+#endif // LIBMESH_COMMUNICATION_LOG_H
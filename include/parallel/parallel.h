@@ -746,6 +746,15 @@ namespace Parallel
     status probe (const unsigned int src_processor_id,
                   const MessageTag &tag=any_tag) const;
 
+    /**
+     * Non-blocking message probe.  Returns true, and fills in \p stat,
+     * if a message from \p src_processor_id with tag \p tag is ready
+     * to be received.  Returns false immediately otherwise.
+     */
+    bool iprobe (const unsigned int src_processor_id,
+                 const MessageTag &tag,
+                 status &stat) const;
+
     /**
      * Blocking-send to one processor with data-defined type.
      */
@@ -1092,6 +1101,29 @@ namespace Parallel
     template <typename T>
     inline void alltoall(std::vector<T> &r) const;
 
+    /**
+     * Sparse dynamic data exchange.  Sends each vector in
+     * \p data_to_send to the processor it is keyed by, and calls
+     * \p act_on_data(pid, data) once for each vector \p data sent to
+     * this processor by processor \p pid, in arrival order.
+     *
+     * Unlike a pattern of alltoall() followed by point-to-point
+     * messages, no processor needs to know in advance who will send
+     * to it: with MPI-3, termination is detected with a nonblocking
+     * consensus (synchronous sends followed by an ibarrier), so the
+     * cost scales with the number of messages rather than with the
+     * number of processors.  A closing barrier keeps consecutive
+     * exchanges with the same tag from mixing their messages.
+     *
+     * \p tag should not be in use by any other pending communication;
+     * use get_unique_tag() to obtain one.
+     */
+    template <typename T, typename ActionFunctor>
+    inline void sparse_exchange
+      (const std::map<unsigned int, std::vector<T> > &data_to_send,
+       ActionFunctor &act_on_data,
+       const MessageTag &tag) const;
+
     /**
      * Take a local value and broadcast it to all processors.
      * Optionally takes the \p root_id processor, which specifies
@@ -28,6 +28,8 @@
 #include "libmesh/parallel.h"
 
 // C++ Includes   -----------------------------------
+#include <map>
+#include <vector>
 
 namespace libMesh
 {
@@ -104,6 +106,147 @@ namespace Parallel {
                                       const Iterator& range_end,
                                       SyncFunctor&    sync);
 
+  //------------------------------------------------------------------------
+  /**
+   * A reusable communication plan for repeatedly synchronizing data
+   * on the same range of ghost dofobjects.  The first sync through a
+   * plan exchanges the ids to be requested from each processor, like
+   * Parallel::sync_dofobject_data_by_id(); the plan then remembers
+   * them, so later syncs only need to send the data itself, and only
+   * to processors known to need it.
+   *
+   * On every sync the plan checks whether any processor's range of
+   * ghost objects (or the owners of those objects) has changed since
+   * the ids were last exchanged, and if so it rebuilds itself.  The
+   * check compares a checksum of the ranges, computed in one pass
+   * without building any id lists, and costs one reduction of a
+   * single flag, rather than the id exchange of an unplanned sync.
+   * A plan must be used with the same communicator every time.
+   */
+  class SyncPlan
+  {
+  public:
+    /**
+     * Constructor.  The plan is built the first time it is used.
+     */
+    SyncPlan () : _n_requested(0), _checksum(0), _initialized(false) {}
+
+    /**
+     * Discards the cached ids, forcing them to be exchanged again on
+     * the next sync.  Must be called on all processors at once.
+     */
+    void clear ();
+
+    /**
+     * Request data about a range of ghost dofobjects uniquely
+     * identified by their id, using the same \p SyncFunctor
+     * interface as Parallel::sync_dofobject_data_by_id().
+     */
+    template <typename Iterator,
+              typename SyncFunctor>
+    void sync_dofobject_data_by_id(const Communicator& communicator,
+                                   const Iterator&     range_begin,
+                                   const Iterator&     range_end,
+                                   SyncFunctor&        sync);
+
+  private:
+
+    /**
+     * Exchanges ids if the range of objects has changed on any
+     * processor since the last call.
+     */
+    template <typename Iterator>
+    void update (const Communicator& communicator,
+                 const Iterator&     range_begin,
+                 const Iterator&     range_end);
+
+    /**
+     * Stores the ids requested of us by each processor.
+     */
+    struct StoreRequests
+    {
+      explicit
+      StoreRequests (std::map<unsigned int, std::vector<dof_id_type> > &r) :
+        ids_to_fill(r) {}
+
+      void operator() (const unsigned int pid, std::vector<dof_id_type> &ids)
+      { ids_to_fill[pid].swap(ids); }
+
+      std::map<unsigned int, std::vector<dof_id_type> > &ids_to_fill;
+    };
+
+    /**
+     * The ids of our ghost objects owned by each other processor.
+     */
+    std::map<unsigned int, std::vector<dof_id_type> > _requested_ids;
+
+    /**
+     * The ids of our objects each other processor has requested.
+     */
+    std::map<unsigned int, std::vector<dof_id_type> > _ids_to_fill;
+
+    /**
+     * The number of ids in \p _requested_ids, and a checksum of them
+     * and their owners, to detect changes to the range.
+     */
+    std::size_t _n_requested;
+    std::size_t _checksum;
+
+    /**
+     * Whether the ids have been exchanged yet.
+     */
+    bool _initialized;
+  };
+
+  //------------------------------------------------------------------------
+  /**
+   * Fills the requests received by sync_dofobject_data_by_id()
+   * using sync.gather_data().
+   */
+  template <typename SyncFunctor>
+  struct SyncByIdGatherData
+  {
+    typedef typename SyncFunctor::datum datum;
+
+    SyncByIdGatherData (SyncFunctor &s,
+                        std::map<unsigned int, std::vector<datum> > &d) :
+      sync(s), data(d) {}
+
+    void operator() (const unsigned int pid,
+                     std::vector<dof_id_type> &request_to_fill_id)
+    { sync.gather_data(request_to_fill_id, data[pid]); }
+
+    SyncFunctor &sync;
+    std::map<unsigned int, std::vector<datum> > &data;
+  };
+
+  //------------------------------------------------------------------------
+  /**
+   * Passes the data received by sync_dofobject_data_by_id(), along
+   * with the ids it was requested for, to sync.act_on_data().
+   */
+  template <typename SyncFunctor>
+  struct SyncByIdActOnData
+  {
+    typedef typename SyncFunctor::datum datum;
+
+    SyncByIdActOnData (SyncFunctor &s,
+                       std::map<unsigned int, std::vector<dof_id_type> > &r) :
+      sync(s), requested_objs_id(r) {}
+
+    void operator() (const unsigned int pid,
+                     std::vector<datum> &received_data)
+    {
+      libmesh_assert(requested_objs_id.count(pid));
+      libmesh_assert_equal_to (requested_objs_id[pid].size(),
+                               received_data.size());
+      sync.act_on_data(requested_objs_id[pid], received_data);
+    }
+
+    SyncFunctor &sync;
+    std::map<unsigned int, std::vector<dof_id_type> > &requested_objs_id;
+  };
+
   //------------------------------------------------------------------------
   // Parallel members
 
@@ -255,13 +398,12 @@ void sync_dofobject_data_by_id(const Communicator& communicator,
     }
 
   // Request sets to send to each processor
-  std::vector<std::vector<dof_id_type> >
-    requested_objs_id(communicator.size());
+  std::map<unsigned int, std::vector<dof_id_type> > requested_objs_id;
 
   // We know how many objects live on each processor, so reserve()
   // space for each.
   for (processor_id_type p=0; p != communicator.size(); ++p)
-    if (p != communicator.rank())
+    if (p != communicator.rank() && ghost_objects_from_proc[p])
       {
         requested_objs_id[p].reserve(ghost_objects_from_proc[p]);
       }
@@ -276,35 +418,20 @@ void sync_dofobject_data_by_id(const Communicator& communicator,
       requested_objs_id[obj_procid].push_back(obj->id());
     }
 
-  // Trade requests with other processors
-  for (processor_id_type p=1; p != communicator.size(); ++p)
-    {
-      // Trade my requests with processor procup and procdown
-      const processor_id_type procup =
-        libmesh_cast_int<processor_id_type>
-	  (communicator.rank() + p) % communicator.size();
-      const processor_id_type procdown =
-        libmesh_cast_int<processor_id_type>
-	  ((communicator.size() + communicator.rank() - p) %
-           communicator.size());
-      std::vector<dof_id_type> request_to_fill_id;
-      communicator.send_receive(procup, requested_objs_id[procup],
-				procdown, request_to_fill_id);
-
-      // Gather whatever data the user wants
-      std::vector<typename SyncFunctor::datum> data;
-      sync.gather_data(request_to_fill_id, data);
-
-      // Trade back the results
-      std::vector<typename SyncFunctor::datum> received_data;
-      communicator.send_receive(procdown, data,
-                             procup, received_data);
-      libmesh_assert_equal_to (requested_objs_id[procup].size(),
-                               received_data.size());
-
-      // Let the user process the results
-      sync.act_on_data(requested_objs_id[procup], received_data);
-    }
+  // Trade requests with only the processors we need to talk to,
+  // gathering whatever data the user wants as requests arrive
+  std::map<unsigned int, std::vector<typename SyncFunctor::datum> > data;
+  {
+    SyncByIdGatherData<SyncFunctor> gather(sync, data);
+    communicator.sparse_exchange
+      (requested_objs_id, gather, communicator.get_unique_tag(1357));
+  }
+
+  // Trade back the results, letting the user process them as they
+  // arrive
+  SyncByIdActOnData<SyncFunctor> act(sync, requested_objs_id);
+  communicator.sparse_exchange
+    (data, act, communicator.get_unique_tag(1358));
 }
 
 
@@ -431,6 +558,136 @@ void sync_element_data_by_parent_id(MeshBase&,
 
 
 
+  //------------------------------------------------------------------------
+  // SyncPlan members
+
+inline
+void SyncPlan::clear ()
+{
+  _requested_ids.clear();
+  _ids_to_fill.clear();
+  _n_requested = 0;
+  _checksum = 0;
+  _initialized = false;
+}
+
+
+
+template <typename Iterator>
+void SyncPlan::update (const Communicator& communicator,
+                       const Iterator&     range_begin,
+                       const Iterator&     range_end)
+{
+  // Checksum the ids to ask each processor about, in the order in
+  // which we would request them
+  std::size_t n_requested = 0, checksum = 0;
+
+  for (Iterator it = range_begin; it != range_end; ++it)
+    {
+      DofObject *obj = *it;
+      libmesh_assert (obj);
+      processor_id_type obj_procid = obj->processor_id();
+      if (obj_procid == communicator.rank() ||
+          obj_procid == DofObject::invalid_processor_id)
+        continue;
+
+      checksum = (checksum * 31 + obj_procid) * 1000003 + obj->id();
+      n_requested++;
+    }
+
+  // If no processor's requests have changed, we're still valid
+  bool changed = (!_initialized ||
+                  n_requested != _n_requested ||
+                  checksum != _checksum);
+  communicator.max(changed);
+  if (!changed)
+    return;
+
+  START_LOG("update()", "SyncPlan");
+
+  _requested_ids.clear();
+  _ids_to_fill.clear();
+
+  for (Iterator it = range_begin; it != range_end; ++it)
+    {
+      DofObject *obj = *it;
+      processor_id_type obj_procid = obj->processor_id();
+      if (obj_procid == communicator.rank() ||
+          obj_procid == DofObject::invalid_processor_id)
+        continue;
+
+      _requested_ids[obj_procid].push_back(obj->id());
+    }
+
+  _n_requested = n_requested;
+  _checksum = checksum;
+
+  StoreRequests store_requests(_ids_to_fill);
+  communicator.sparse_exchange
+    (_requested_ids, store_requests, communicator.get_unique_tag(1359));
+
+  _initialized = true;
+
+  STOP_LOG("update()", "SyncPlan");
+}
+
+
+
+template <typename Iterator,
+          typename SyncFunctor>
+void SyncPlan::sync_dofobject_data_by_id(const Communicator& communicator,
+                                         const Iterator&     range_begin,
+                                         const Iterator&     range_end,
+                                         SyncFunctor&        sync)
+{
+  // This function must be run on all processors at once
+  libmesh_parallel_only(communicator);
+
+  this->update(communicator, range_begin, range_end);
+
+  typedef typename SyncFunctor::datum datum;
+
+  MessageTag data_tag = communicator.get_unique_tag(1360);
+
+  // We know how much data we'll get from each processor, so we can
+  // post all our receives up front
+  std::vector<std::vector<datum> > received_data(_requested_ids.size());
+  std::vector<Request> receive_requests(_requested_ids.size());
+
+  std::map<unsigned int, std::vector<dof_id_type> >::iterator
+    it = _requested_ids.begin();
+  for (std::size_t i=0; it != _requested_ids.end(); ++it, ++i)
+    {
+      received_data[i].resize(it->second.size());
+      communicator.receive(it->first, received_data[i],
+                           receive_requests[i], data_tag);
+    }
+
+  // Gather whatever data the user wants for each request
+  std::vector<std::vector<datum> > data(_ids_to_fill.size());
+  std::vector<Request> send_requests(_ids_to_fill.size());
+
+  it = _ids_to_fill.begin();
+  for (std::size_t i=0; it != _ids_to_fill.end(); ++it, ++i)
+    {
+      sync.gather_data(it->second, data[i]);
+      libmesh_assert_equal_to (data[i].size(), it->second.size());
+      communicator.send(it->first, data[i], send_requests[i], data_tag);
+    }
+
+  // Let the user process the results
+  it = _requested_ids.begin();
+  for (std::size_t i=0; it != _requested_ids.end(); ++it, ++i)
+    {
+      receive_requests[i].wait();
+      sync.act_on_data(it->second, received_data[i]);
+    }
+
+  Parallel::wait(send_requests);
+}
+
+
+
 
 }
 
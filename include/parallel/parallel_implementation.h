@@ -22,6 +22,7 @@
 // Local includes
 #include "parallel.h"
 #include "libmesh_logging.h"
+#include "communication_log.h"
 
 // C++ includes
 #include <iterator> // iterator_traits
@@ -218,6 +219,22 @@ inline void unpack_vector_bool(const std::vector<T> &in,
 
 
 #ifdef LIBMESH_HAVE_MPI
+// Internal helper function to get the size in bytes of count
+// entries of an MPI type, for the CommunicationLog.  We skip the
+// MPI_Type_size call when communication is not being logged.
+inline std::size_t logged_bytes(const Parallel::DataType &type,
+                                const std::size_t count)
+{
+  if (!Parallel::CommunicationLog::enabled())
+    return 0;
+
+  int type_size = 0;
+  MPI_Type_size (type, &type_size);
+
+  return count * type_size;
+}
+
+
 // We use a helper function here to avoid ambiguity when calling
 // send_receive of (vector<vector<T>>,vector<vector<T>>)
 template <typename T1, typename T2>
@@ -700,7 +717,10 @@ inline Status Request::wait ()
 
   Status stat;
 #ifdef LIBMESH_HAVE_MPI
-  MPI_Wait (&_request, stat.get());
+  {
+    CommunicationLog::Sentry log_comm (CommunicationLog::WAIT, 0);
+    MPI_Wait (&_request, stat.get());
+  }
 #endif
   if (post_wait_work)
     for (std::vector<PostWaitWork*>::iterator i =
@@ -778,6 +798,7 @@ inline void Communicator::barrier () const
     {
       START_LOG("barrier()", "Parallel");
 
+      CommunicationLog::Sentry log_comm (CommunicationLog::BARRIER, 0);
       MPI_Barrier (this->get());
 
       STOP_LOG("barrier()", "Parallel");
@@ -1295,6 +1316,7 @@ inline void Communicator::min(T &r) const
       START_LOG("min(scalar)", "Parallel");
 
       T temp = r;
+      CommunicationLog::Sentry log_comm (CommunicationLog::MIN_MAX, sizeof(temp));
       MPI_Allreduce (&temp,
                      &r,
                      1,
@@ -1315,6 +1337,7 @@ inline void Communicator::min(bool &r) const
 
       unsigned int tempsend = r;
       unsigned int temp;
+      CommunicationLog::Sentry log_comm (CommunicationLog::MIN_MAX, sizeof(tempsend));
       MPI_Allreduce (&tempsend,
                      &temp,
                      1,
@@ -1338,6 +1361,7 @@ inline void Communicator::min(std::vector<T> &r) const
       libmesh_assert(this->verify(r.size()));
 
       std::vector<T> temp(r);
+      CommunicationLog::Sentry log_comm (CommunicationLog::MIN_MAX, r.size()*sizeof(T));
       MPI_Allreduce (&temp[0],
                      &r[0],
                      libmesh_cast_int<int>(r.size()),
@@ -1361,6 +1385,7 @@ inline void Communicator::min(std::vector<bool> &r) const
       std::vector<unsigned int> ruint;
       pack_vector_bool(r, ruint);
       std::vector<unsigned int> temp(ruint.size());
+      CommunicationLog::Sentry log_comm (CommunicationLog::MIN_MAX, ruint.size()*sizeof(unsigned int));
       MPI_Allreduce (&ruint[0],
                      &temp[0],
                      libmesh_cast_int<int>(ruint.size()),
@@ -1386,6 +1411,7 @@ inline void Communicator::minloc(T &r,
       in.val = r;
       in.rank = this->rank();
       DataPlusInt<T> out;
+      CommunicationLog::Sentry log_comm (CommunicationLog::MIN_MAX, sizeof(in));
       MPI_Allreduce (&in,
                      &out,
                      1,
@@ -1413,6 +1439,7 @@ inline void Communicator::minloc(bool &r,
       in.val = r;
       in.rank = this->rank();
       DataPlusInt<int> out;
+      CommunicationLog::Sentry log_comm (CommunicationLog::MIN_MAX, sizeof(in));
       MPI_Allreduce (&in,
                      &out,
                      1,
@@ -1446,6 +1473,7 @@ inline void Communicator::minloc(std::vector<T> &r,
           in[i].rank = this->rank();
         }
       std::vector<DataPlusInt<T> > out(r.size());
+      CommunicationLog::Sentry log_comm (CommunicationLog::MIN_MAX, in.size()*sizeof(in[0]));
       MPI_Allreduce (&in[0],
                      &out[0],
                      libmesh_cast_int<int>(r.size()),
@@ -1484,6 +1512,7 @@ inline void Communicator::minloc(std::vector<bool> &r,
           in[i].rank = this->rank();
         }
       std::vector<DataPlusInt<int> > out(r.size());
+      CommunicationLog::Sentry log_comm (CommunicationLog::MIN_MAX, in.size()*sizeof(in[0]));
       MPI_Allreduce (&in[0],
                      &out[0],
                      libmesh_cast_int<int>(r.size()),
@@ -1514,6 +1543,7 @@ inline void Communicator::max(T &r) const
       START_LOG("max(scalar)", "Parallel");
 
       T temp;
+      CommunicationLog::Sentry log_comm (CommunicationLog::MIN_MAX, sizeof(r));
       MPI_Allreduce (&r,
                      &temp,
                      1,
@@ -1535,6 +1565,7 @@ inline void Communicator::max(bool &r) const
 
       unsigned int tempsend = r;
       unsigned int temp;
+      CommunicationLog::Sentry log_comm (CommunicationLog::MIN_MAX, sizeof(tempsend));
       MPI_Allreduce (&tempsend,
                      &temp,
                      1,
@@ -1558,6 +1589,7 @@ inline void Communicator::max(std::vector<T> &r) const
       libmesh_assert(this->verify(r.size()));
 
       std::vector<T> temp(r);
+      CommunicationLog::Sentry log_comm (CommunicationLog::MIN_MAX, r.size()*sizeof(T));
       MPI_Allreduce (&temp[0],
                      &r[0],
                      libmesh_cast_int<int>(r.size()),
@@ -1581,6 +1613,7 @@ inline void Communicator::max(std::vector<bool> &r) const
       std::vector<unsigned int> ruint;
       pack_vector_bool(r, ruint);
       std::vector<unsigned int> temp(ruint.size());
+      CommunicationLog::Sentry log_comm (CommunicationLog::MIN_MAX, ruint.size()*sizeof(unsigned int));
       MPI_Allreduce (&ruint[0],
                      &temp[0],
                      libmesh_cast_int<int>(ruint.size()),
@@ -1606,6 +1639,7 @@ inline void Communicator::maxloc(T &r,
       in.val = r;
       in.rank = this->rank();
       DataPlusInt<T> out;
+      CommunicationLog::Sentry log_comm (CommunicationLog::MIN_MAX, sizeof(in));
       MPI_Allreduce (&in,
                      &out,
                      1,
@@ -1633,6 +1667,7 @@ inline void Communicator::maxloc(bool &r,
       in.val = r;
       in.rank = this->rank();
       DataPlusInt<int> out;
+      CommunicationLog::Sentry log_comm (CommunicationLog::MIN_MAX, sizeof(in));
       MPI_Allreduce (&in,
                      &out,
                      1,
@@ -1666,6 +1701,7 @@ inline void Communicator::maxloc(std::vector<T> &r,
           in[i].rank = this->rank();
         }
         std::vector<DataPlusInt<T> > out(r.size());
+        CommunicationLog::Sentry log_comm (CommunicationLog::MIN_MAX, in.size()*sizeof(in[0]));
         MPI_Allreduce (&in[0],
                        &out[0],
                        libmesh_cast_int<int>(r.size()),
@@ -1704,6 +1740,7 @@ inline void Communicator::maxloc(std::vector<bool> &r,
           in[i].rank = this->rank();
         }
       std::vector<DataPlusInt<int> > out(r.size());
+      CommunicationLog::Sentry log_comm (CommunicationLog::MIN_MAX, in.size()*sizeof(in[0]));
       MPI_Allreduce (&in[0],
                      &out[0],
                      libmesh_cast_int<int>(r.size()),
@@ -1734,6 +1771,7 @@ inline void Communicator::sum(T &r) const
       START_LOG("sum()", "Parallel");
 
       T temp = r;
+      CommunicationLog::Sentry log_comm (CommunicationLog::SUM, sizeof(temp));
       MPI_Allreduce (&temp,
                      &r,
                      1,
@@ -1756,6 +1794,7 @@ inline void Communicator::sum(std::vector<T> &r) const
       libmesh_assert(this->verify(r.size()));
 
       std::vector<T> temp(r);
+      CommunicationLog::Sentry log_comm (CommunicationLog::SUM, r.size()*sizeof(T));
       MPI_Allreduce (&temp[0],
                      &r[0],
                      libmesh_cast_int<int>(r.size()),
@@ -1778,6 +1817,7 @@ inline void Communicator::sum(std::complex<T> &r) const
       START_LOG("sum()", "Parallel");
 
       std::complex<T> temp(r);
+      CommunicationLog::Sentry log_comm (CommunicationLog::SUM, sizeof(temp));
       MPI_Allreduce (&temp,
                      &r,
                      2,
@@ -1800,6 +1840,7 @@ inline void Communicator::sum(std::vector<std::complex<T> > &r) const
       libmesh_assert(this->verify(r.size()));
 
       std::vector<std::complex<T> > temp(r);
+      CommunicationLog::Sentry log_comm (CommunicationLog::SUM, r.size()*sizeof(temp[0]));
       MPI_Allreduce (&temp[0],
                      &r[0],
                      libmesh_cast_int<int>(r.size() * 2),
@@ -1875,6 +1916,27 @@ inline status Communicator::probe (const unsigned int src_processor_id,
 
 
 
+inline bool Communicator::iprobe (const unsigned int src_processor_id,
+                                  const MessageTag &tag,
+                                  status &stat) const
+{
+  START_LOG("iprobe()", "Parallel");
+
+  int flag = 0;
+
+  MPI_Iprobe (src_processor_id,
+              tag.value(),
+              this->get(),
+              &flag,
+              &stat);
+
+  STOP_LOG("iprobe()", "Parallel");
+
+  return flag;
+}
+
+
+
 template<typename T>
 inline void Communicator::send (const unsigned int dest_processor_id,
                                 std::basic_string<T> &buf,
@@ -1884,6 +1946,7 @@ inline void Communicator::send (const unsigned int dest_processor_id,
 
   T* dataptr = buf.empty() ? NULL : const_cast<T*>(buf.data());
 
+  CommunicationLog::Sentry log_comm (CommunicationLog::SEND, buf.size()*sizeof(T));
 #ifndef NDEBUG
   // Only catch the return value when asserts are active.
   const int ierr =
@@ -1913,6 +1976,7 @@ inline void Communicator::send (const unsigned int dest_processor_id,
 
   T* dataptr = buf.empty() ? NULL : const_cast<T*>(buf.data());
 
+  CommunicationLog::Sentry log_comm (CommunicationLog::SEND, buf.size()*sizeof(T));
 #ifndef NDEBUG
   // Only catch the return value when asserts are active.
   const int ierr =
@@ -1942,6 +2006,7 @@ inline void Communicator::send (const unsigned int dest_processor_id,
 
   T* dataptr = &buf;
 
+  CommunicationLog::Sentry log_comm (CommunicationLog::SEND, sizeof(T));
 #ifndef NDEBUG
   // Only catch the return value when asserts are active.
   const int ierr =
@@ -1971,6 +2036,7 @@ inline void Communicator::send (const unsigned int dest_processor_id,
 
   T* dataptr = &buf;
 
+  CommunicationLog::Sentry log_comm (CommunicationLog::SEND, sizeof(T));
 #ifndef NDEBUG
   // Only catch the return value when asserts are active.
   const int ierr =
@@ -2086,6 +2152,7 @@ inline void Communicator::send (const unsigned int dest_processor_id,
 {
   START_LOG("send()", "Parallel");
 
+  CommunicationLog::Sentry log_comm (CommunicationLog::SEND, logged_bytes(type, buf.size()));
 #ifndef NDEBUG
   // Only catch the return value when asserts are active.
   const int ierr =
@@ -2114,6 +2181,7 @@ inline void Communicator::send (const unsigned int dest_processor_id,
 {
   START_LOG("send()", "Parallel");
 
+  CommunicationLog::Sentry log_comm (CommunicationLog::SEND, logged_bytes(type, buf.size()));
 #ifndef NDEBUG
   // Only catch the return value when asserts are active.
   const int ierr =
@@ -2145,8 +2213,12 @@ inline void Communicator::send_packed_range (const unsigned int dest_processor_i
   typedef typename std::iterator_traits<Iter>::value_type T;
   std::vector<typename Parallel::BufferType<T>::type> buffer;
 
+  CommunicationLog::Sentry log_comm (CommunicationLog::PACKED_RANGE, 0);
+
   Parallel::pack_range(context, range_begin, range_end, buffer);
 
+  log_comm.add_bytes(buffer.size()*sizeof(buffer[0]));
+
   // Blocking send of the buffer
   this->send(dest_processor_id, buffer, tag);
 }
@@ -2166,8 +2238,12 @@ inline void Communicator::send_packed_range (const unsigned int dest_processor_i
   typedef typename Parallel::BufferType<T>::type buffer_t;
   std::vector<buffer_t> *buffer = new std::vector<buffer_t>();
 
+  CommunicationLog::Sentry log_comm (CommunicationLog::PACKED_RANGE, 0);
+
   Parallel::pack_range(context, range_begin, range_end, *buffer);
 
+  log_comm.add_bytes(buffer->size()*sizeof(buffer_t));
+
   // Make the Request::wait() handle deleting the buffer
   req.add_post_wait_work
     (new Parallel::PostWaitDeleteBuffer<std::vector<buffer_t> >
@@ -2232,6 +2308,9 @@ inline Status Communicator::receive (const unsigned int src_processor_id,
 
   // Get the status of the message, explicitly provide the
   // datatype so we can later query the size
+  // Count the time spent waiting for the message too
+  CommunicationLog::Sentry log_comm (CommunicationLog::RECEIVE, 0);
+
   Status stat(this->probe(src_processor_id, tag), StandardType<T>(&buf));
 
 #ifndef NDEBUG
@@ -2262,6 +2341,7 @@ inline void Communicator::receive (const unsigned int src_processor_id,
 {
   START_LOG("receive()", "Parallel");
 
+  CommunicationLog::Sentry log_comm (CommunicationLog::RECEIVE, 0);
 #ifndef NDEBUG
   // Only catch the return value when asserts are active.
   const int ierr =
@@ -2391,6 +2471,9 @@ inline Status Communicator::receive (const unsigned int src_processor_id,
 
   // Get the status of the message, explicitly provide the
   // datatype so we can later query the size
+  // Count the time spent waiting for the message too
+  CommunicationLog::Sentry log_comm (CommunicationLog::RECEIVE, 0);
+
   Status stat(this->probe(src_processor_id, tag), type);
 
   buf.resize(stat.size());
@@ -2424,6 +2507,7 @@ inline void Communicator::receive (const unsigned int src_processor_id,
 {
   START_LOG("receive()", "Parallel");
 
+  CommunicationLog::Sentry log_comm (CommunicationLog::RECEIVE, 0);
 #ifndef NDEBUG
   // Only catch the return value when asserts are active.
   const int ierr =
@@ -2452,6 +2536,7 @@ inline void Communicator::receive_packed_range (const unsigned int src_processor
 
   // Receive serialized variable size objects as a sequence of ints
   std::vector<buffer_t> buffer;
+  CommunicationLog::Sentry log_comm (CommunicationLog::PACKED_RANGE, 0);
   this->receive(src_processor_id, buffer, tag);
   Parallel::unpack_range(buffer, context, out);
 }
@@ -2538,6 +2623,12 @@ inline void Communicator::send_receive(const unsigned int dest_processor_id,
       return;
     }
 
+  // Count the send half without a time, and charge the time to the
+  // receive half
+  if (CommunicationLog::enabled())
+    CommunicationLog::record (CommunicationLog::SEND, sizeof(T1), 0.);
+
+  CommunicationLog::Sentry log_comm (CommunicationLog::RECEIVE, 0);
   MPI_Sendrecv(&sendvec, 1, StandardType<T1>(&sendvec),
                dest_processor_id, send_tag.value(),
                &recv, 1, StandardType<T2>(&recv),
@@ -2686,6 +2777,7 @@ inline void Communicator::gather(const unsigned int root_id,
 
       StandardType<T> send_type(&sendval);
 
+      CommunicationLog::Sentry log_comm (CommunicationLog::GATHER, sizeof(T));
       MPI_Gather(&sendval,
                  1,
                  send_type,
@@ -2750,6 +2842,7 @@ inline void Communicator::gather(const unsigned int root_id,
     r.resize(globalsize);
 
   // and get the data from the remote processors
+  CommunicationLog::Sentry log_comm (CommunicationLog::GATHER, mysize*sizeof(T));
 #ifndef NDEBUG
   // Only catch the return value when asserts are active.
   const int ierr =
@@ -2780,6 +2873,7 @@ inline void Communicator::allgather(T sendval,
     {
       StandardType<T> send_type(&sendval);
 
+      CommunicationLog::Sentry log_comm (CommunicationLog::ALLGATHER, sizeof(T));
       MPI_Allgather (&sendval,
                      1,
                      send_type,
@@ -2817,6 +2911,7 @@ inline void Communicator::allgather
       r_src.swap(r);
       StandardType<T> send_type(&r_src[0]);
 
+      CommunicationLog::Sentry log_comm (CommunicationLog::ALLGATHER, r_src.size()*sizeof(T));
       MPI_Allgather (&r_src[0],
                      libmesh_cast_int<int>(r_src.size()),
                      send_type,
@@ -2860,6 +2955,7 @@ inline void Communicator::allgather
 
   // and get the data from the remote processors.
   // Pass NULL if our vector is empty.
+  CommunicationLog::Sentry log_comm (CommunicationLog::ALLGATHER, mysize*sizeof(T));
 #ifndef NDEBUG
   // Only catch the return value when asserts are active.
   const int ierr =
@@ -2888,8 +2984,12 @@ inline void Communicator::allgather_packed_range
   // *range_end as a sequence of ints in this buffer
   std::vector<buffer_t> buffer;
 
+  CommunicationLog::Sentry log_comm (CommunicationLog::PACKED_RANGE, 0);
+
   Parallel::pack_range(context, range_begin, range_end, buffer);
 
+  log_comm.add_bytes(buffer.size()*sizeof(buffer_t));
+
   this->allgather(buffer, false);
 
   Parallel::unpack_range(buffer, context, out);
@@ -2918,6 +3018,7 @@ inline void Communicator::alltoall(std::vector<T> &buf) const
 
   StandardType<T> send_type(&tmp[0]);
 
+  CommunicationLog::Sentry log_comm (CommunicationLog::ALLTOALL, buf.size()*sizeof(T));
 #ifndef NDEBUG
   // Only catch the return value when asserts are active.
   const int ierr =
@@ -2936,6 +3037,149 @@ inline void Communicator::alltoall(std::vector<T> &buf) const
 
 
 
+template <typename T, typename ActionFunctor>
+inline void Communicator::sparse_exchange
+  (const std::map<unsigned int, std::vector<T> > &data_to_send,
+   ActionFunctor &act_on_data,
+   const MessageTag &tag) const
+{
+  START_LOG("sparse_exchange()", "Parallel");
+
+  std::vector<Request> send_requests;
+  send_requests.reserve(data_to_send.size());
+
+  // Data we send to ourselves doesn't need to go through MPI
+  std::vector<T> received;
+  bool have_local_data = false;
+
+  typename std::map<unsigned int, std::vector<T> >::const_iterator
+    it = data_to_send.begin();
+  const typename std::map<unsigned int, std::vector<T> >::const_iterator
+    end = data_to_send.end();
+
+#if MPI_VERSION < 3
+  // Without a nonblocking barrier, tell each processor how many
+  // messages to expect.  We do this before sending anything, so that
+  // no processor can send messages for a later exchange with the
+  // same tag before every processor has received all of this one's.
+  std::vector<unsigned int> n_messages_to(this->size(), 0);
+  for (; it != end; ++it)
+    if (it->first != this->rank())
+      n_messages_to[it->first] = 1;
+  it = data_to_send.begin();
+
+  this->alltoall(n_messages_to);
+#endif
+
+  for (; it != end; ++it)
+    {
+      const unsigned int dest_processor_id = it->first;
+      libmesh_assert_less (dest_processor_id, this->size());
+
+      if (dest_processor_id == this->rank())
+        {
+          received = it->second;
+          have_local_data = true;
+          continue;
+        }
+
+      // Older MPI implementations take non-const send buffers
+      std::vector<T> &buf = const_cast<std::vector<T>&>(it->second);
+
+      send_requests.push_back(Request());
+
+      // Synchronous sends only complete once they have been matched
+      // by a receive, which is what lets us detect termination below
+      CommunicationLog::Sentry log_comm (CommunicationLog::SEND, buf.size()*sizeof(T));
+#ifndef NDEBUG
+      // Only catch the return value when asserts are active.
+      const int ierr =
+#endif
+        MPI_Issend (buf.empty() ? NULL : &buf[0],
+                    libmesh_cast_int<int>(buf.size()),
+                    StandardType<T>(buf.empty() ? NULL : &buf[0]),
+                    dest_processor_id,
+                    tag.value(),
+                    this->get(),
+                    send_requests.back().get());
+      libmesh_assert (ierr == MPI_SUCCESS);
+    }
+
+  if (have_local_data)
+    act_on_data(this->rank(), received);
+
+#if MPI_VERSION < 3
+  unsigned int n_messages_from = 0;
+  for (unsigned int p=0; p != this->size(); ++p)
+    n_messages_from += n_messages_to[p];
+
+  for (unsigned int m=0; m != n_messages_from; ++m)
+    {
+      const Status stat = this->receive(any_source, received, tag);
+      act_on_data(static_cast<unsigned int>(stat.source()), received);
+    }
+#else
+  // Receive messages until every processor has had all of its sends
+  // matched, which we learn from a barrier that each processor only
+  // enters once its own sends are complete.
+  Request barrier_request;
+  bool in_barrier = false;
+
+  while (true)
+    {
+      status stat;
+      if (this->iprobe(any_source, tag, stat))
+        {
+          const unsigned int source =
+            static_cast<unsigned int>(Status(stat).source());
+          this->receive(source, received, tag);
+          act_on_data(source, received);
+        }
+
+      if (in_barrier)
+        {
+          if (barrier_request.test())
+            break;
+        }
+      else
+        {
+          bool sends_complete = true;
+          for (std::size_t i=0; i != send_requests.size(); ++i)
+            if (!send_requests[i].test())
+              {
+                sends_complete = false;
+                break;
+              }
+
+          if (sends_complete)
+            {
+              CommunicationLog::Sentry log_comm (CommunicationLog::BARRIER, 0);
+#ifndef NDEBUG
+              // Only catch the return value when asserts are active.
+              const int ierr =
+#endif
+                MPI_Ibarrier (this->get(), barrier_request.get());
+              libmesh_assert (ierr == MPI_SUCCESS);
+
+              in_barrier = true;
+            }
+        }
+    }
+
+  // Seeing the barrier complete only tells us that every message of
+  // this exchange has been received.  A processor which sees it
+  // before we do may go on to a later exchange with the same tag,
+  // whose messages we would otherwise mistake for this one's above.
+  this->barrier();
+#endif
+
+  Parallel::wait(send_requests);
+
+  STOP_LOG("sparse_exchange()", "Parallel");
+}
+
+
+
 template <typename T>
 inline void Communicator::broadcast (T &data, const unsigned int root_id) const
 {
@@ -2951,6 +3195,8 @@ inline void Communicator::broadcast (T &data, const unsigned int root_id) const
   START_LOG("broadcast()", "Parallel");
 
   // Spread data to remote processors.
+  CommunicationLog::Sentry log_comm
+    (CommunicationLog::BROADCAST, (this->rank() == root_id) ? sizeof(T) : 0);
 #ifndef NDEBUG
   // Only catch the return value when asserts are active.
   const int ierr =
@@ -3023,6 +3269,8 @@ inline void Communicator::broadcast (std::vector<T> &data,
   // Pass NULL if our vector is empty.
   T *data_ptr = data.empty() ? NULL : &data[0];
 
+  CommunicationLog::Sentry log_comm
+    (CommunicationLog::BROADCAST, (this->rank() == root_id) ? data.size()*sizeof(T) : 0);
 #ifndef NDEBUG
   // Only catch the return value when asserts are active.
   const int ierr =
@@ -3205,8 +3453,13 @@ inline void Communicator::broadcast_packed_range
   // *range_end as a sequence of ints in this buffer
   std::vector<buffer_t> buffer;
 
+  CommunicationLog::Sentry log_comm (CommunicationLog::PACKED_RANGE, 0);
+
   if (this->rank() == root_id)
-    Parallel::pack_range(context1, range_begin, range_end, buffer);
+    {
+      Parallel::pack_range(context1, range_begin, range_end, buffer);
+      log_comm.add_bytes(buffer.size()*sizeof(buffer_t));
+    }
 
   // this->broadcast(vector) requires the receiving vectors to
   // already be the appropriate size
@@ -3269,6 +3522,14 @@ inline status Communicator::probe (const unsigned int,
                                    const MessageTag&) const
 { libmesh_error(); status s; return s; }
 
+/**
+ * Without MPI no messages can ever be waiting.
+ */
+inline bool Communicator::iprobe (const unsigned int,
+                                  const MessageTag&,
+                                  status&) const
+{ return false; }
+
 /**
  * We do not currently support sends on one processor without MPI.
  */
@@ -3394,6 +3655,23 @@ inline void Communicator::allgather(std::vector<T> &, const bool) const {}
 template <typename T>
 inline void Communicator::alltoall(std::vector<T> &) const {}
 
+template <typename T, typename ActionFunctor>
+inline void Communicator::sparse_exchange
+  (const std::map<unsigned int, std::vector<T> > &data_to_send,
+   ActionFunctor &act_on_data,
+   const MessageTag &) const
+{
+  // With one processor, all data goes to ourselves
+  typename std::map<unsigned int, std::vector<T> >::const_iterator
+    it = data_to_send.begin();
+  for (; it != data_to_send.end(); ++it)
+    {
+      libmesh_assert_equal_to (it->first, 0);
+      std::vector<T> received(it->second);
+      act_on_data(0, received);
+    }
+}
+
 template <typename T>
 inline void Communicator::broadcast (T &, const unsigned int root_id) const
 { libmesh_assert_equal_to(root_id, 0); }
@@ -51,9 +51,9 @@ public:
   /**
    * Constructor takes the number of processors,
    * the processor id, and a reference to a vector of data
-   * to be sorted.  This vector is sorted by
-   * the constructor, therefore, construction of
-   * a Sort object takes O(nlogn) time,
+   * to be sorted.  This vector is sorted (using all
+   * available threads) by the constructor, therefore,
+   * construction of a Sort object takes O(nlogn) time,
    * where n is the length of the vector.
    */
   Sort (const Parallel::Communicator &comm,
@@ -114,10 +114,24 @@ private:
    */
   std::vector<KeyType> _my_bin;
 
+  /**
+   * The offset in _my_bin of each sorted run of keys
+   * received from another processor.
+   */
+  std::vector<std::size_t> _bin_run_starts;
+
   /**
    * Sorts the local data into bins across all processors.
-   * Right now it constructs a BenSorter<KeyType> object.
-   * In the future this could be a template parameter.
+   * The bin boundaries are chosen by regular sampling: each
+   * processor contributes regularly spaced samples of its
+   * sorted data, weighted by the number of keys they stand
+   * for, and the boundaries split the samples into pieces of
+   * equal weight.  If the keys are distinct, this guarantees that
+   * no bin holds more than twice the average number of keys,
+   * however they are distributed, using a single round of
+   * communication.  All copies of a key go to the same bin, which
+   * callers rely on to look keys up by bin, so a key repeated many
+   * times can make its bin larger than that.
    */
   void binsort ();
 
@@ -131,8 +145,9 @@ private:
 
   /**
    * After all the bins have been communicated, we can
-   * sort our local bin.  This is nothing more than a
-   * call to std::sort
+   * sort our local bin.  Each processor's contribution is
+   * already sorted, so this merges those runs (using all
+   * available threads).
    */
   void sort_local_bin();
 
@@ -48,6 +48,8 @@
 #  include "libmesh/libmesh_logging.h" // only mess with the perflog if we are really multithreaded
 #  include <pthread.h>
 #  include <algorithm>
+#  include <deque>
+#  include <set>
 #  include <vector>
 
 #ifdef __APPLE__
@@ -66,6 +68,9 @@
 #    include "tbb/enumerable_thread_specific.h"
 #    define LIBMESH_TLS_TYPE(type)  tbb::enumerable_thread_specific<type>
 #    define LIBMESH_TLS_REF(value)  (value).local()
+#  elif defined(LIBMESH_HAVE_PTHREAD)
+#    define LIBMESH_TLS_TYPE(type)  libMesh::Threads::thread_specific<type>
+#    define LIBMESH_TLS_REF(value)  (value).local()
 #  else // Maybe support gcc __thread eventually?
 #    define LIBMESH_TLS_TYPE(type)  type
 #    define LIBMESH_TLS_REF(value)  (value)
@@ -181,7 +186,9 @@ namespace Threads
   {
     BoolAcquire b(in_threads);
 
-#ifdef LIBMESH_ENABLE_PERFORMANCE_LOGGING
+    // The PerfLog keeps a log per thread by means of pthread
+    // thread-specific data; without that it is not thread-safe.
+#if defined(LIBMESH_ENABLE_PERFORMANCE_LOGGING) && !defined(LIBMESH_HAVE_PTHREAD)
     const bool logging_was_enabled = libMesh::perflog.logging_enabled();
 
     if (libMesh::n_threads() > 1)
@@ -194,7 +201,7 @@ namespace Threads
     else
       body(range);
 
-#ifdef LIBMESH_ENABLE_PERFORMANCE_LOGGING
+#if defined(LIBMESH_ENABLE_PERFORMANCE_LOGGING) && !defined(LIBMESH_HAVE_PTHREAD)
     if (libMesh::n_threads() > 1 && logging_was_enabled)
       libMesh::perflog.enable_logging();
 #endif
@@ -213,7 +220,7 @@ namespace Threads
   {
     BoolAcquire b(in_threads);
 
-#ifdef LIBMESH_ENABLE_PERFORMANCE_LOGGING
+#if defined(LIBMESH_ENABLE_PERFORMANCE_LOGGING) && !defined(LIBMESH_HAVE_PTHREAD)
     const bool logging_was_enabled = libMesh::perflog.logging_enabled();
 
     if (libMesh::n_threads() > 1)
@@ -226,7 +233,7 @@ namespace Threads
     else
       body(range);
 
-#ifdef LIBMESH_ENABLE_PERFORMANCE_LOGGING
+#if defined(LIBMESH_ENABLE_PERFORMANCE_LOGGING) && !defined(LIBMESH_HAVE_PTHREAD)
     if (libMesh::n_threads() > 1 && logging_was_enabled)
       libMesh::perflog.enable_logging();
 #endif
@@ -245,7 +252,7 @@ namespace Threads
   {
     BoolAcquire b(in_threads);
 
-#ifdef LIBMESH_ENABLE_PERFORMANCE_LOGGING
+#if defined(LIBMESH_ENABLE_PERFORMANCE_LOGGING) && !defined(LIBMESH_HAVE_PTHREAD)
     const bool logging_was_enabled = libMesh::perflog.logging_enabled();
 
     if (libMesh::n_threads() > 1)
@@ -258,7 +265,7 @@ namespace Threads
     else
       body(range);
 
-#ifdef LIBMESH_ENABLE_PERFORMANCE_LOGGING
+#if defined(LIBMESH_ENABLE_PERFORMANCE_LOGGING) && !defined(LIBMESH_HAVE_PTHREAD)
     if (libMesh::n_threads() > 1 && logging_was_enabled)
       libMesh::perflog.enable_logging();
 #endif
@@ -277,7 +284,7 @@ namespace Threads
   {
     BoolAcquire b(in_threads);
 
-#ifdef LIBMESH_ENABLE_PERFORMANCE_LOGGING
+#if defined(LIBMESH_ENABLE_PERFORMANCE_LOGGING) && !defined(LIBMESH_HAVE_PTHREAD)
     const bool logging_was_enabled = libMesh::perflog.logging_enabled();
 
     if (libMesh::n_threads() > 1)
@@ -290,7 +297,7 @@ namespace Threads
        else
 	 body(range);
 
-#ifdef LIBMESH_ENABLE_PERFORMANCE_LOGGING
+#if defined(LIBMESH_ENABLE_PERFORMANCE_LOGGING) && !defined(LIBMESH_HAVE_PTHREAD)
     if (libMesh::n_threads() > 1 && logging_was_enabled)
       libMesh::perflog.enable_logging();
 #endif
@@ -469,27 +476,325 @@ namespace Threads
 
   //-------------------------------------------------------------------
   /**
-   * Scheduler to manage threads.
+   * Dummy "splitting object" used to distinguish splitting constructors
+   * from copy constructors.
    */
-  class task_scheduler_init
+  class split {};
+
+
+
+  //-------------------------------------------------------------------
+  /**
+   * A unit of work to be run by the \p ThreadPool.
+   */
+  class PoolTask
   {
   public:
-    static const int automatic = -1;
-    explicit task_scheduler_init (int = automatic) {}
-    void initialize (int = automatic) {}
-    void terminate () {}
+    virtual ~PoolTask () {}
+
+    /**
+     * Does the work.  May spawn more tasks.
+     */
+    virtual void execute () = 0;
   };
 
+
+
   //-------------------------------------------------------------------
   /**
-   * Dummy "splitting object" used to distinguish splitting constructors
-   * from copy constructors.
+   * Counts the outstanding tasks of one parallel operation, so that
+   * the thread which started it can tell when they have all finished.
    */
-  class split {};
+  class TaskGroup
+  {
+  public:
+    TaskGroup () : _n_pending(0) {}
+
+    void add () { spin_mutex::scoped_lock lock(_mutex); ++_n_pending; }
+
+    void done () { spin_mutex::scoped_lock lock(_mutex); --_n_pending; }
+
+    bool finished () { spin_mutex::scoped_lock lock(_mutex); return !_n_pending; }
+
+  private:
+    spin_mutex _mutex;
+    unsigned int _n_pending;
+  };
+
+
+
+  //-------------------------------------------------------------------
+  /**
+   * A persistent pool of worker threads, which parallel_for() and
+   * parallel_reduce() use when neither TBB nor OpenMP is available.
+   * The pool is created by \p task_scheduler_init, and hence by
+   * \p LibMeshInit, so that parallel loops don't pay for creating
+   * threads on every call.
+   *
+   * Each thread, including the one which started the pool, has its
+   * own queue of tasks.  Threads take their own newest tasks first,
+   * and when they run out steal the oldest tasks of other threads.
+   * Since ranges are split in half recursively, the oldest tasks are
+   * the largest, so a few steals balance the load.  A thread which is
+   * waiting for some tasks to finish runs other tasks meanwhile, so
+   * parallel loops may safely be nested.
+   */
+  class ThreadPool
+  {
+  public:
+    /**
+     * Starts \p n_threads - 1 worker threads; the calling thread
+     * becomes the n_threads-th.  Does nothing if \p n_threads < 2.
+     */
+    static void start (const unsigned int n_threads);
+
+    /**
+     * Stops and joins the worker threads.  There must be no
+     * outstanding tasks.
+     */
+    static void stop ();
+
+    /**
+     * Returns true if the pool is running and the calling thread is
+     * one of its threads, so that it may spawn and wait for tasks.
+     */
+    static bool available ();
+
+    /**
+     * Returns the index of the calling thread in the pool.
+     */
+    static unsigned int thread_index ();
+
+    /**
+     * Adds \p task to the calling thread's queue.  The pool deletes
+     * the task after it is executed.
+     */
+    static void spawn (PoolTask *task);
+
+    /**
+     * Runs tasks until every task in \p group has finished, sleeping
+     * while the remaining tasks all run on other threads.
+     */
+    static void wait (TaskGroup &group);
+  };
+
+
+
+  //-------------------------------------------------------------------
+  /**
+   * A task which applies a parallel_for() body to a range, first
+   * splitting off halves of the range for other threads to steal
+   * until it is no larger than its grain size, as TBB does.
+   */
+  template <typename Range, typename Body>
+  class ParallelForTask : public PoolTask
+  {
+  public:
+    ParallelForTask (Range *range, const Body &body, TaskGroup &group) :
+      _range(range), _body(body), _group(group) {}
+
+    virtual ~ParallelForTask () { delete _range; }
+
+    virtual void execute ()
+    {
+      while (_range->is_divisible())
+        {
+          _group.add();
+          ThreadPool::spawn
+            (new ParallelForTask<Range,Body>
+               (new Range(*_range, Threads::split()), _body, _group));
+        }
+
+      _body(*_range);
+
+      _group.done();
+    }
+
+  private:
+    Range *_range;
+    const Body &_body;
+    TaskGroup &_group;
+  };
+
+
 
+  template <typename Range, typename Body>
+  void pool_parallel_reduce (Range &range, Body &body);
+
+  //-------------------------------------------------------------------
+  /**
+   * A task which applies a parallel_reduce() body to part of a range
+   * split off by another task.  As with TBB, the body is only split
+   * if the task is stolen: a task run by the thread which spawned it,
+   * while that thread waits, accumulates into the spawning body,
+   * provided that body already holds everything which precedes the
+   * task's range.
+   */
+  template <typename Range, typename Body>
+  class ParallelReduceTask : public PoolTask
+  {
+  public:
+    ParallelReduceTask (Range *range,
+                        Body &parent_body,
+                        Body *&stolen_body,
+                        const unsigned int parent_thread,
+                        const std::size_t index,
+                        std::size_t &inline_child,
+                        TaskGroup &group) :
+      _range(range),
+      _parent_body(parent_body),
+      _stolen_body(stolen_body),
+      _parent_thread(parent_thread),
+      _index(index),
+      _inline_child(inline_child),
+      _group(group) {}
+
+    virtual ~ParallelReduceTask () { delete _range; }
+
+    virtual void execute ()
+    {
+      // Only the parent thread reads or writes _inline_child
+      if (ThreadPool::thread_index() == _parent_thread &&
+          _inline_child == _index + 1)
+        {
+          // Keep our earlier siblings out of the body until we are done
+          _inline_child = 0;
+          pool_parallel_reduce(*_range, _parent_body);
+          _inline_child = _index;
+        }
+      else
+        {
+          Body *body = new Body(_parent_body, Threads::split());
+          _stolen_body = body;
+          pool_parallel_reduce(*_range, *body);
+        }
+
+      _group.done();
+    }
+
+  private:
+    Range *_range;
+    Body &_parent_body;
+    Body *&_stolen_body;
+    const unsigned int _parent_thread;
+    const std::size_t _index;
+    std::size_t &_inline_child;
+    TaskGroup &_group;
+  };
 
 
 
+  //-------------------------------------------------------------------
+  /**
+   * Applies \p body to \p range on the \p ThreadPool.
+   */
+  template <typename Range, typename Body>
+  void pool_parallel_for (const Range &range, const Body &body)
+  {
+    if (!ThreadPool::available())
+      {
+        body(range);
+        return;
+      }
+
+    TaskGroup group;
+    group.add();
+
+    // Run the first task ourselves
+    ParallelForTask<Range,Body> root(new Range(range), body, group);
+    root.execute();
+
+    ThreadPool::wait(group);
+  }
+
+
+
+  //-------------------------------------------------------------------
+  /**
+   * Reduces \p range into \p body on the \p ThreadPool.
+   */
+  template <typename Range, typename Body>
+  void pool_parallel_reduce (Range &range, Body &body)
+  {
+    if (!ThreadPool::available())
+      {
+        body(range);
+        return;
+      }
+
+    TaskGroup children;
+
+    // Bodies created by the children which were stolen, in the
+    // order the children were spawned.  A deque, so that the
+    // children's references into it stay valid as it grows.
+    std::deque<Body*> stolen_bodies;
+
+    // One more than the index of the child which may accumulate
+    // directly into body, or 0 if none may
+    std::size_t inline_child = 0;
+
+    while (range.is_divisible())
+      {
+        stolen_bodies.push_back(NULL);
+        children.add();
+        ThreadPool::spawn
+          (new ParallelReduceTask<Range,Body>
+             (new Range(range, Threads::split()), body,
+              stolen_bodies.back(), ThreadPool::thread_index(),
+              stolen_bodies.size() - 1, inline_child, children));
+      }
+
+    body(range);
+
+    inline_child = stolen_bodies.size();
+    ThreadPool::wait(children);
+
+    // Each child was split off the end of what remained of range, so
+    // earlier children hold later subranges, and the children which
+    // accumulated into body hold the subranges right after ours.
+    for (std::size_t i = stolen_bodies.size(); i != 0; --i)
+      if (stolen_bodies[i-1])
+        {
+          body.join(*stolen_bodies[i-1]);
+          delete stolen_bodies[i-1];
+        }
+  }
+
+
+
+  //-------------------------------------------------------------------
+  /**
+   * Scheduler to manage threads.  Starts the \p ThreadPool when
+   * it is constructed and stops it when it is destroyed.
+   */
+  class task_scheduler_init
+  {
+  public:
+    static const int automatic = -1;
+    explicit task_scheduler_init (int n = automatic) : _initialized(false)
+    { this->initialize(n); }
+    ~task_scheduler_init () { this->terminate(); }
+    void initialize (int n = automatic)
+    {
+#if !LIBMESH_HAVE_OPENMP
+      libmesh_assert(!_initialized);
+      ThreadPool::start((n == automatic) ? libMesh::n_threads() :
+                        static_cast<unsigned int>(n));
+      _initialized = true;
+#else
+      libmesh_ignore(n);
+#endif
+    }
+    void terminate ()
+    {
+      if (_initialized)
+        ThreadPool::stop();
+      _initialized = false;
+    }
+  private:
+    bool _initialized;
+  };
+
   //-------------------------------------------------------------------
   /**
    * Exectue the provided function object in parallel on the specified
@@ -499,20 +804,22 @@ namespace Threads
   inline
   void parallel_for (const Range &range, const Body &body)
   {
-    Threads::BoolAcquire b(Threads::in_threads);
-
-#ifdef LIBMESH_ENABLE_PERFORMANCE_LOGGING
-    const bool logging_was_enabled = libMesh::perflog.logging_enabled();
-
-    if (libMesh::n_threads() > 1)
-      libMesh::perflog.disable_logging();
+#if !LIBMESH_HAVE_OPENMP
+    // A nested loop just adds more tasks to the pool
+    if (Threads::in_threads)
+      {
+        pool_parallel_for(range, body);
+        return;
+      }
 #endif
 
+    Threads::BoolAcquire b(Threads::in_threads);
+
+#if LIBMESH_HAVE_OPENMP
     unsigned int n_threads = num_pthreads(range);
 
     std::vector<Range *> ranges(n_threads);
     std::vector<RangeBody<const Range, const Body> > range_bodies(n_threads);
-    std::vector<pthread_t> threads(n_threads);
 
     // Create the ranges for each thread
     unsigned int range_size = range.size() / n_threads;
@@ -541,33 +848,13 @@ namespace Threads
     // Create the threads
     #pragma omp parallel for schedule (static)
     for(unsigned int i=0; i<n_threads; i++)
-    {
-#if LIBMESH_HAVE_OPENMP
       run_body<Range, Body>((void*)&range_bodies[i]);
-#else // Just use Pthreads
-      spin_mutex::scoped_lock lock(_pthread_unique_id_mutex);
-      pthread_create(&threads[i], NULL, &run_body<Range, Body>, (void*)&range_bodies[i]);
-      _pthread_unique_ids[threads[i]] = i;
-#endif
-    }
-
-#if !LIBMESH_HAVE_OPENMP
-    // Wait for them to finish
-    for(unsigned int i=0; i<n_threads; i++)
-    {
-      pthread_join(threads[i], NULL);
-      spin_mutex::scoped_lock lock(_pthread_unique_id_mutex);
-      _pthread_unique_ids.erase(threads[i]);
-    }
-#endif
 
     // Clean up
     for(unsigned int i=0; i<n_threads; i++)
       delete ranges[i];
-
-#ifdef LIBMESH_ENABLE_PERFORMANCE_LOGGING
-    if (libMesh::n_threads() > 1 && logging_was_enabled)
-      libMesh::perflog.enable_logging();
+#else
+    pool_parallel_for(range, body);
 #endif
   }
 
@@ -592,15 +879,19 @@ namespace Threads
   inline
   void parallel_reduce (const Range &range, Body &body)
   {
-    Threads::BoolAcquire b(Threads::in_threads);
-
-#ifdef LIBMESH_ENABLE_PERFORMANCE_LOGGING
-    const bool logging_was_enabled = libMesh::perflog.logging_enabled();
-
-    if (libMesh::n_threads() > 1)
-      libMesh::perflog.disable_logging();
+#if !LIBMESH_HAVE_OPENMP
+    // A nested reduction just adds more tasks to the pool
+    if (Threads::in_threads)
+      {
+        Range root_range(range);
+        pool_parallel_reduce(root_range, body);
+        return;
+      }
 #endif
 
+    Threads::BoolAcquire b(Threads::in_threads);
+
+#if LIBMESH_HAVE_OPENMP
     unsigned int n_threads = num_pthreads(range);
 
     std::vector<Range *> ranges(n_threads);
@@ -637,29 +928,9 @@ namespace Threads
     }
 
     // Create the threads
-    std::vector<pthread_t> threads(n_threads);
-
     #pragma omp parallel for schedule (static)
     for(unsigned int i=0; i<n_threads; i++)
-    {
-#if LIBMESH_HAVE_OPENMP
       run_body<Range, Body>((void*)&range_bodies[i]);
-#else // Just use Pthreads
-      spin_mutex::scoped_lock lock(_pthread_unique_id_mutex);
-      pthread_create(&threads[i], NULL, &run_body<Range, Body>, (void*)&range_bodies[i]);
-      _pthread_unique_ids[threads[i]] = i;
-#endif
-    }
-
-#if !LIBMESH_HAVE_OPENMP
-    // Wait for them to finish
-    for(unsigned int i=0; i<n_threads; i++)
-    {
-      pthread_join(threads[i], NULL);
-      spin_mutex::scoped_lock lock(_pthread_unique_id_mutex);
-      _pthread_unique_ids.erase(threads[i]);
-    }
-#endif
 
     // Join them all down to the original Body
     for(unsigned int i=n_threads-1; i != 0; i--)
@@ -670,10 +941,9 @@ namespace Threads
       delete bodies[i];
     for(unsigned int i=0; i<n_threads; i++)
       delete ranges[i];
-
-#ifdef LIBMESH_ENABLE_PERFORMANCE_LOGGING
-    if (libMesh::n_threads() > 1 && logging_was_enabled)
-      libMesh::perflog.enable_logging();
+#else
+    Range root_range(range);
+    pool_parallel_reduce(root_range, body);
 #endif
   }
 
@@ -764,6 +1034,68 @@ namespace Threads
     spin_mutex smutex;
   };
 
+  //-------------------------------------------------------------------
+  /**
+   * A separate, default constructed \p T for each thread which calls
+   * \p local(), kept under a pthread key.  This implements
+   * \p LIBMESH_TLS_TYPE when pthreads are the only threading model.
+   * A thread's \p T is deleted when the thread exits, and the rest
+   * when the \p thread_specific object is destroyed.
+   */
+  template <typename T>
+  class thread_specific
+  {
+  public:
+    thread_specific () { pthread_key_create (&_key, &thread_specific::destroy); }
+
+    ~thread_specific ()
+    {
+      pthread_key_delete (_key);
+
+      for (typename std::set<Slot*>::iterator it = _slots.begin();
+           it != _slots.end(); ++it)
+        delete *it;
+    }
+
+    T & local ()
+    {
+      Slot *slot = static_cast<Slot*>(pthread_getspecific(_key));
+
+      if (!slot)
+        {
+          slot = new Slot(*this);
+          pthread_setspecific (_key, slot);
+
+          spin_mutex::scoped_lock lock(_mutex);
+          _slots.insert(slot);
+        }
+
+      return slot->value;
+    }
+
+  private:
+    struct Slot
+    {
+      Slot (thread_specific &owner_in) : owner(owner_in), value() {}
+      thread_specific &owner;
+      T value;
+    };
+
+    static void destroy (void *p)
+    {
+      Slot *slot = static_cast<Slot*>(p);
+      {
+        spin_mutex::scoped_lock lock(slot->owner._mutex);
+        slot->owner._slots.erase(slot);
+      }
+      delete slot;
+    }
+
+    pthread_key_t _key;
+    std::set<Slot*> _slots;
+    spin_mutex _mutex;
+  };
+
 #else //LIBMESH_HAVE_PTHREAD
 
   //-------------------------------------------------------------------
@@ -0,0 +1,159 @@
+// The libMesh Finite Element Library.
+// Copyright (C) 2002-2012 Benjamin S. Kirk, John W. Peterson, Roy H. Stogner
+
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+
+
+#ifndef LIBMESH_DIFFUSION_PARTITIONER_H
+#define LIBMESH_DIFFUSION_PARTITIONER_H
+
+// Local Includes -----------------------------------
+#include "libmesh/partitioner.h"
+
+// C++ Includes   -----------------------------------
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace libMesh
+{
+
+// Forward Declarations
+class Elem;
+
+
+/**
+ * The \p DiffusionPartitioner incrementally rebalances an existing
+ * partitioning.  Rather than computing a new partitioning from
+ * scratch, it moves work only between partitions which share element
+ * faces, so that most elements (and hence most of the data attached
+ * to them) stay where they are.
+ *
+ * The amount of work to move between each pair of neighboring
+ * partitions is found by first-order diffusion on the partition
+ * adjacency graph, which is iterated only until the imbalance drops
+ * below \p imbalance_tolerance().  Larger tolerances therefore trade
+ * balance for less element migration.  Elements are then moved
+ * across partition boundaries, preferring elements which have the
+ * most faces on the receiving partition so that the edge cut does
+ * not grow.
+ *
+ * Elements which have never been partitioned are first assigned a
+ * space-filling-curve based partitioning, which is then improved
+ * in the same way.
+ */
+
+// ------------------------------------------------------------
+// DiffusionPartitioner class definition
+class DiffusionPartitioner : public Partitioner
+{
+ public:
+
+  /**
+   * Constructor.
+   */
+  DiffusionPartitioner () :
+    _imbalance_tolerance(1.05),
+    _max_diffusion_steps(100)
+  {}
+
+  /**
+   * Creates a new partitioner of this type and returns it in
+   * an \p AutoPtr.
+   */
+  virtual AutoPtr<Partitioner> clone () const {
+    DiffusionPartitioner *dp = new DiffusionPartitioner();
+    dp->_imbalance_tolerance = _imbalance_tolerance;
+    dp->_max_diffusion_steps = _max_diffusion_steps;
+    AutoPtr<Partitioner> cloned_partitioner (dp);
+    return cloned_partitioner;
+  }
+
+  /**
+   * Attach weights to be balanced instead of element counts.  As for
+   * the other partitioners, this ErrorVector should be _exactly_ the
+   * same on every processor and should have mesh->max_elem_id()
+   * entries.
+   */
+  virtual void attach_weights(ErrorVector * weights) { _weights = weights; }
+
+  /**
+   * The largest acceptable ratio of the heaviest partition weight to
+   * the mean partition weight.  No elements are moved if the current
+   * partitioning is already within this tolerance.  Defaults to 1.05.
+   */
+  Real & imbalance_tolerance () { return _imbalance_tolerance; }
+
+  /**
+   * The maximum number of diffusion steps used to compute the work
+   * to be moved between neighboring partitions.  Each step only moves
+   * work one partition further from an overloaded partition, so
+   * fewer steps mean more local (but less complete) rebalancing.
+   * Defaults to 100.
+   */
+  unsigned int & max_diffusion_steps () { return _max_diffusion_steps; }
+
+protected:
+
+  /**
+   * Rebalance the current partitioning of the \p MeshBase
+   * into \p n subdomains.
+   */
+  virtual void _do_partition (MeshBase& mesh,
+			      const unsigned int n);
+
+  /**
+   * Identical to \p _do_partition(), which is already incremental.
+   */
+  virtual void _do_repartition (MeshBase& mesh,
+				const unsigned int n)
+  { this->_do_partition (mesh, n); }
+
+private:
+
+  /**
+   * Computes the net amount of weight to be moved between each pair
+   * of adjacent partitions, given the partition weights \p load and
+   * the partition adjacency \p edges.  On return \p flow[i] holds the
+   * weight to be moved from \p edges[i].first to \p edges[i].second;
+   * a negative value indicates movement in the opposite direction.
+   */
+  void compute_flows (const std::vector<Real>& load,
+		      const std::vector<std::pair<unsigned int, unsigned int> >& edges,
+		      std::vector<Real>& flow) const;
+
+  /**
+   * Returns the partitioning weight of \p elem.
+   */
+  Real elem_weight (const Elem* elem) const;
+
+  /**
+   * The imbalance tolerance.
+   */
+  Real _imbalance_tolerance;
+
+  /**
+   * The maximum number of diffusion steps.
+   */
+  unsigned int _max_diffusion_steps;
+};
+
+
+} // namespace libMesh
+
+
+
+#endif // LIBMESH_DIFFUSION_PARTITIONER_H
@@ -27,6 +27,8 @@
 
 // C++ Includes   -----------------------------------
 #include <cstddef>
+#include <utility>
+#include <vector>
 
 namespace libMesh
 {
@@ -52,7 +54,7 @@ class Partitioner
   /**
    * Constructor.
    */
-  Partitioner ():_weights(NULL) {}
+  Partitioner ():_weights(NULL), _collect_statistics(false) {}
 
   /**
    * Destructor. Virtual so that we can derive from this class.
@@ -130,6 +132,72 @@ class Partitioner
    */
   virtual void attach_weights(ErrorVector * /*weights*/) { libmesh_not_implemented(); }
 
+  /**
+   * Measures of the quality of the most recent partitioning.  All
+   * entries are global quantities, identical on every processor.
+   */
+  struct PartitionStatistics
+  {
+    PartitionStatistics () :
+      n_partitions(0),
+      min_active_elem(0),
+      max_active_elem(0),
+      imbalance(1.),
+      edge_cut(0),
+      n_migrated(0) {}
+
+    /**
+     * The number of partitions created.
+     */
+    unsigned int n_partitions;
+
+    /**
+     * The smallest and largest number of active elements
+     * assigned to any one partition.
+     */
+    dof_id_type min_active_elem, max_active_elem;
+
+    /**
+     * The ratio of the largest partition size to the mean
+     * partition size.  A perfectly balanced partitioning has
+     * an imbalance of 1.
+     */
+    Real imbalance;
+
+    /**
+     * The number of element faces shared by active elements
+     * which were assigned to different partitions.
+     */
+    dof_id_type edge_cut;
+
+    /**
+     * The number of active elements whose processor id was
+     * changed by the partitioning.  Elements which were previously
+     * unpartitioned are not counted.
+     */
+    dof_id_type n_migrated;
+  };
+
+  /**
+   * If \p collect is true, partition quality statistics will be
+   * computed after each call to \p partition() or \p repartition().
+   * Statistics are also collected, and printed to \p libMesh::out,
+   * whenever the \p --print-partition-statistics command line option
+   * is given.
+   */
+  void collect_statistics (const bool collect) { _collect_statistics = collect; }
+
+  /**
+   * Returns the statistics computed during the most recent
+   * partitioning, if statistics collection was enabled.
+   */
+  const PartitionStatistics & statistics () const { return _statistics; }
+
+  /**
+   * Prints the statistics of the most recent partitioning.
+   */
+  void print_statistics (std::ostream& os=libMesh::out) const;
+
 protected:
 
   /**
@@ -166,6 +234,42 @@ protected:
    * The weights that might be used for partitioning.
    */
   ErrorVector * _weights;
+
+private:
+
+  /**
+   * Returns true if statistics should be computed for this
+   * partitioning.
+   */
+  bool _want_statistics () const;
+
+  /**
+   * Records the current processor ids of the active elements this
+   * processor is responsible for, so that element migration can be
+   * measured after partitioning.
+   */
+  static void _save_processor_ids
+    (const MeshBase& mesh,
+     std::vector<std::pair<dof_id_type, processor_id_type> >& saved_ids);
+
+  /**
+   * Computes \p _statistics for the current partitioning of \p mesh.
+   * \p saved_ids should hold the output of \p _save_processor_ids
+   * from before the partitioning.
+   */
+  void _compute_statistics
+    (const MeshBase& mesh,
+     const std::vector<std::pair<dof_id_type, processor_id_type> >& saved_ids);
+
+  /**
+   * Whether to compute \p _statistics after each partitioning.
+   */
+  bool _collect_statistics;
+
+  /**
+   * Quality statistics from the most recent partitioning.
+   */
+  PartitionStatistics _statistics;
 };
 
 
@@ -214,6 +214,23 @@ public:
    */
   bool allow_rules_with_negative_weights;
 
+  /**
+   * Flag (default true) controlling the use of the rule cache.  When
+   * set, \p init() copies rules it has computed before, for any
+   * \p QBase object of the same type, dimension and order, from a
+   * global cache instead of recomputing them.  This saves the
+   * tensor products and conical transforms of the higher order rules
+   * when FE objects are reinitialized on different element types, as
+   * they are on mixed element meshes.  Rules whose points depend on
+   * anything else should clear this flag.
+   */
+  bool use_rule_cache;
+
+  /**
+   * Deletes all the rules in the global rule cache.
+   */
+  static void clear_rule_cache ();
+
 protected:
 
 
@@ -348,6 +365,7 @@ inline
 QBase::QBase(const unsigned int d,
 	     const Order o) :
   allow_rules_with_negative_weights(true),
+  use_rule_cache(true),
   _dim(d),
   _order(o),
   _type(INVALID_ELEM),
@@ -95,6 +95,19 @@ class QGauss : public QBase
   void keast_rule(const Real rule_data[][4],
 		  const unsigned int n_pts);
 
+  /**
+   * Like keast_rule(), but the permutation type of each set of points
+   * is given explicitly, which also allows points with four distinct
+   * barycentric coordinates.  Resizes _points and _weights itself.
+   * This function is only used internally by the high-order TET rules.
+   */
+  void keast_rule2(const Real* wts,
+		   const Real* a,
+		   const Real* b,
+		   const Real* c,
+		   const unsigned int* permutation_ids,
+		   const unsigned int n_wts);
+
 };
 
 
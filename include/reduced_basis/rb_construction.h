@@ -123,6 +123,26 @@ public:
    */
   virtual void clear ();
 
+  /**
+   * @returns an estimate of the number of bytes of memory used on
+   * this processor by the vectors of this system, including the
+   * affine operator vectors and Riesz representors.
+   */
+  virtual std::size_t vector_memory_usage () const;
+
+  /**
+   * @returns an estimate of the number of bytes of memory used on
+   * this processor by the matrices of this system, including the
+   * affine operator matrices.
+   */
+  virtual std::size_t matrix_memory_usage () const;
+
+  /**
+   * @returns an estimate of the number of bytes of memory used on
+   * this processor by this system and its \p RBEvaluation.
+   */
+  virtual std::size_t memory_usage () const;
+
   /**
    * @returns a string indicating the type of the system.
    */
@@ -161,6 +161,13 @@ public:
    */
   virtual void clear_riesz_representors();
 
+  /**
+   * @returns an estimate of the number of bytes of memory used on
+   * this processor by the basis functions, the Riesz representors
+   * and the reduced basis data.
+   */
+  virtual std::size_t memory_usage() const;
+
   /**
    * Write out all the data to text files in order to segregate the
    * Offline stage from the Online stage.
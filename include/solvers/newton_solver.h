@@ -119,6 +119,28 @@ public:
    */
   Real linear_tolerance_multiplier;
 
+  /**
+   * This function enables the user to provide a shell matrix, e.g. a
+   * \p FEMJacobianShellMatrix, to use as the Jacobian.  The system
+   * matrix is then no longer assembled; the linear solves use the
+   * shell matrix instead, and the linear solver must support shell
+   * matrices.  You can reset this behaviour to its original state by
+   * supplying a \p NULL pointer to this function.
+   */
+  void attach_shell_matrix (ShellMatrix<Number>* shell_matrix)
+  { _shell_matrix = shell_matrix; }
+
+  /**
+   * Detaches a shell matrix.  Same as \p attach_shell_matrix(NULL).
+   */
+  void detach_shell_matrix (void) { attach_shell_matrix(NULL); }
+
+  /**
+   * Returns a pointer to the currently attached shell matrix, if any,
+   * or \p NULL else.
+   */
+  ShellMatrix<Number>* get_shell_matrix(void) { return _shell_matrix; }
+
 protected:
 
   /**
@@ -129,6 +151,11 @@ protected:
    */
   AutoPtr<LinearSolver<Number> > linear_solver;
 
+  /**
+   * User supplied shell matrix or \p NULL if the system matrix is used.
+   */
+  ShellMatrix<Number>* _shell_matrix;
+
   /**
    * This does a line search in the direction opposite linear_solution
    * to try and minimize the residual of newton_iterate.
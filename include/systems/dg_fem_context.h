@@ -22,6 +22,7 @@
 
 // Local Includes
 #include "libmesh/fem_context.h"
+#include "libmesh/side_map_cache.h"
 
 
 namespace libMesh
@@ -237,6 +238,14 @@ public:
   template<typename OutputShape>
   void get_neighbor_side_fe( unsigned int var, FEGenericBase<OutputShape> *& fe ) const;
 
+  /**
+   * If true, neighbor_side_fe_reinit() maps the side quadrature
+   * points onto a conforming neighbor directly, rather than by
+   * inverting the neighbor's map.  Both give the same points, to
+   * within the inverse map tolerance.  True by default.
+   */
+  bool use_side_map_cache;
+
 private:
 
   /**
@@ -293,6 +302,11 @@ private:
    * assembled and should be used in the global matrix assembly.
    */
   bool _dg_terms_active;
+
+  /**
+   * The side quadrature points mapped onto conforming neighbors.
+   */
+  SideMapCache _side_map_cache;
 };
 
 template<typename OutputShape>
@@ -0,0 +1,142 @@
+// The libMesh Finite Element Library.
+// Copyright (C) 2002-2012 Benjamin S. Kirk, John W. Peterson, Roy H. Stogner
+
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+
+
+#ifndef LIBMESH_ELEMENT_MATRIX_CACHE_H
+#define LIBMESH_ELEMENT_MATRIX_CACHE_H
+
+// Local includes
+#include "libmesh/libmesh_common.h"
+#include "libmesh/dense_matrix.h"
+#include "libmesh/threads.h"
+
+// C++ includes
+#include <cstddef>
+#include <map>
+#include <ostream>
+#include <vector>
+
+namespace libMesh
+{
+
+// forward declarations
+class BoundaryInfo;
+class Elem;
+
+/**
+ * This class stores element matrices keyed by the geometry of their
+ * elements, so that an assembly loop can reuse the matrix of an
+ * element for every other element which is an exact translate of it.
+ * Structured meshes, like those of \p MeshTools::Generation, and
+ * extruded meshes have only a handful of distinct elements up to
+ * translation.
+ *
+ * Reusing a matrix is only correct if it depends on nothing but the
+ * element's shape and the data in its key: this holds for constant
+ * coefficient linear operators, but not for operators which depend
+ * on the solution or on the physical coordinates.  Any other data the
+ * matrix depends on (coefficients, time step sizes) must be added to
+ * the key, or the cache must be cleared whenever it changes.
+ *
+ * The cache counts its hits and misses, so that users can check
+ * whether it is paying off on their meshes.
+ */
+class ElementMatrixCache
+{
+public:
+
+  /**
+   * The key type.  Keys are compared exactly, so there are no hash
+   * collisions to worry about.
+   */
+  typedef std::vector<Real> Key;
+
+  /**
+   * Constructor.  The cache is empty.
+   */
+  ElementMatrixCache ();
+
+  /**
+   * Computes the key of \p elem into \p key.  The key consists of the
+   * type, p refinement level and subdomain of \p elem, the boundary
+   * ids of its sides without neighbors, the order of the ids of its
+   * vertices (which orients the degrees of freedom of some families),
+   * the positions of its nodes relative to its first node, rounded
+   * to about \p 1.e-12 times its size, and finally \p coefficients.
+   */
+  static void build_key (const Elem& elem,
+                         const BoundaryInfo& boundary_info,
+                         const std::vector<Real>& coefficients,
+                         Key& key);
+
+  /**
+   * @returns the matrix stored with \p key, or \p NULL if there is
+   * none, and counts the hit or miss.  Stored matrices stay valid
+   * until the cache is cleared.  This method is thread safe.
+   */
+  const DenseMatrix<Number>* find (const Key& key);
+
+  /**
+   * Stores \p matrix with \p key, if no matrix is stored with it
+   * yet.  This method is thread safe.
+   */
+  void insert (const Key& key, const DenseMatrix<Number>& matrix);
+
+  /**
+   * Empties the cache and resets its statistics.
+   */
+  void clear ();
+
+  /**
+   * @returns the number of matrices in the cache.
+   */
+  std::size_t size () const { return _matrices.size(); }
+
+  /**
+   * @returns the number of calls to \p find() which found a matrix.
+   */
+  std::size_t n_hits () const { return _n_hits; }
+
+  /**
+   * @returns the number of calls to \p find() which did not.
+   */
+  std::size_t n_misses () const { return _n_misses; }
+
+  /**
+   * @returns the fraction of calls to \p find() which found a matrix,
+   * or zero if there were none.
+   */
+  Real hit_rate () const;
+
+  /**
+   * Prints the size and statistics of the cache to \p os.
+   */
+  void print_info (std::ostream& os=libMesh::out) const;
+
+private:
+
+  std::map<Key, DenseMatrix<Number> > _matrices;
+
+  std::size_t _n_hits, _n_misses;
+
+  Threads::spin_mutex _mutex;
+};
+
+} // namespace libMesh
+
+#endif // LIBMESH_ELEMENT_MATRIX_CACHE_H
@@ -376,9 +376,24 @@ public:
 
   /**
    * Prints information about the equation systems, by default to
-   * libMesh::out.
+   * libMesh::out.  If \p memory is true, the output of
+   * \p get_memory_info() follows.
    */
-  void print_info (std::ostream& os=libMesh::out) const;
+  void print_info (std::ostream& os=libMesh::out,
+                   const bool memory=false) const;
+
+  /**
+   * @returns an estimate of the number of bytes of memory used on
+   * this processor by the mesh and all the systems.
+   */
+  std::size_t memory_usage () const;
+
+  /**
+   * @returns a string containing the estimated memory used on this
+   * processor by the mesh and by each system, broken down by
+   * subsystem, along with the peak memory usage of the process.
+   */
+  std::string get_memory_info () const;
 
   /**
    * Same as above, but allows you to also use stream syntax.
@@ -22,9 +22,11 @@
 
 // Local Includes
 #include "libmesh/diff_context.h"
+#include "libmesh/dual_number.h"
 #include "libmesh/id_types.h"
 #include "libmesh/fe_type.h"
 #include "libmesh/fe_base.h"
+#include "libmesh/fe_map_batch.h"
 #include "libmesh/vector_value.h"
 
 #ifdef LIBMESH_ENABLE_SECOND_DERIVATIVES
@@ -32,6 +34,7 @@
 #endif
 
 // C++ includes
+#include <algorithm>
 #include <map>
 
 namespace libMesh
@@ -475,6 +478,75 @@ public:
   void interior_div(unsigned int var, unsigned int qp,
 		    OutputType& div_u) const;
 
+  /**
+   * Returns the value of the solution variable \p var at the
+   * quadrature point \p qp on the current element interior, as a
+   * dual number whose derivatives are taken with respect to the
+   * element degrees of freedom being differentiated by
+   * \p ad_residual().
+   */
+  template<typename T, unsigned int N>
+  void interior_value(unsigned int var, unsigned int qp,
+                      DualNumber<T,N>& u) const;
+
+  /**
+   * Returns the gradient of the solution variable \p var at the
+   * quadrature point \p qp on the current element interior, with
+   * derivatives as for the dual number \p interior_value().
+   */
+  template<typename T, unsigned int N>
+  void interior_gradient(unsigned int var, unsigned int qp,
+                         VectorValue<DualNumber<T,N> >& du) const;
+
+  /**
+   * Returns the value of the solution variable \p var at the
+   * quadrature point \p qp on the current element side, with
+   * derivatives as for the dual number \p interior_value().
+   */
+  template<typename T, unsigned int N>
+  void side_value(unsigned int var, unsigned int qp,
+                  DualNumber<T,N>& u) const;
+
+  /**
+   * Returns the gradient of the solution variable \p var at the
+   * quadrature point \p qp on the current element side, with
+   * derivatives as for the dual number \p interior_value().
+   */
+  template<typename T, unsigned int N>
+  void side_gradient(unsigned int var, unsigned int qp,
+                     VectorValue<DualNumber<T,N> >& du) const;
+
+  /**
+   * Adds a residual to the element residual and, if
+   * \p request_jacobian, its derivatives to the element jacobian,
+   * computed by forward mode automatic differentiation.  This is an
+   * alternative to hand coded jacobians, and to the numerical
+   * jacobians FEMSystem falls back on, for element_time_derivative(),
+   * element_constraint() and their side equivalents.
+   *
+   * \p residual is a functor with a member template
+   *
+   * \verbatim
+   * template <typename T>
+   * void operator() (const FEMContext& c, std::vector<T>& F) const;
+   * \endverbatim
+   *
+   * which adds the residual of the current element (or side) to \p F,
+   * indexed like \p get_elem_residual(), with \p T being either
+   * \p Number or \p DualNumber<Number,N>.  It should get the solution
+   * from the templated interior_value(), interior_gradient(),
+   * side_value() and side_gradient() into variables of type \p T (or
+   * \p VectorValue<T>), and apply math functions to them unqualified.
+   *
+   * The jacobian is computed \p N columns at a time, so \p residual
+   * is called once per \p N element degrees of freedom, and the
+   * result is exact up to roundoff.  The jacobian is scaled by
+   * \p get_elem_solution_derivative(), as analytic jacobians are.
+   */
+  template<unsigned int N, typename ResidualFunctor>
+  void ad_residual(const ResidualFunctor& residual,
+                   bool request_jacobian);
+
   /**
    * Reinitialize all my FEM context data on a given
    * element for the given system
@@ -523,6 +595,20 @@ public:
    */
   void edge_fe_reinit();
 
+  /**
+   * Computes the maps of a block of elements at once, to be used by
+   * \p elem_fe_reinit() on those elements instead of computing each
+   * one separately.  Only the affine elements of \p elems with the
+   * type of the first of them are batched; others are reinitialized
+   * as usual.  Nothing is batched if there is a moving mesh system,
+   * since element geometry then changes between reinits.
+   *
+   * The batch is kept until the next call, so elements must not be
+   * moved or deleted while it is in use; pass an empty vector to
+   * clear it.
+   */
+  void batch_elem_maps(const std::vector<const Elem*>& elems);
+
   /**
    * Accessor for element interior quadrature rule.
    */
@@ -731,6 +817,33 @@ protected:
   QBase *edge_qrule;
 
 private:
+  /**
+   * The dual number value and gradient of variable \p var from its
+   * shape functions \p phi or their gradients \p dphi.
+   */
+  template<typename T, unsigned int N>
+  void _dual_value(unsigned int var,
+                   const std::vector<std::vector<Real> > &phi,
+                   unsigned int qp, DualNumber<T,N>& u) const;
+
+  template<typename T, unsigned int N>
+  void _dual_gradient(unsigned int var,
+                      const std::vector<std::vector<RealGradient> > &dphi,
+                      unsigned int qp, VectorValue<DualNumber<T,N> >& du) const;
+
+  /**
+   * The first element degree of freedom being differentiated by
+   * \p ad_residual(); dual numbers get the derivatives with respect to
+   * it and the following ones.
+   */
+  unsigned int _dual_seed_begin;
+
+  /**
+   * The precomputed maps of the elements given to
+   * \p batch_elem_maps().
+   */
+  FEMapBatch _map_batch;
+
   /**
    * Uses the coordinate data specified by mesh_*_position configuration
    * to set the geometry of \p elem to the value it would take after a fraction
@@ -806,6 +919,140 @@ FEBase* FEMContext::get_edge_fe( unsigned int var ) const
   return libmesh_cast_ptr<FEBase*>( _edge_fe_var[var] );
 }
 
+template<typename T, unsigned int N>
+inline
+void FEMContext::interior_value(unsigned int var, unsigned int qp,
+                                DualNumber<T,N>& u) const
+{
+  this->_dual_value(var, this->get_element_fe(var)->get_phi(), qp, u);
+}
+
+template<typename T, unsigned int N>
+inline
+void FEMContext::interior_gradient(unsigned int var, unsigned int qp,
+                                   VectorValue<DualNumber<T,N> >& du) const
+{
+  this->_dual_gradient(var, this->get_element_fe(var)->get_dphi(), qp, du);
+}
+
+template<typename T, unsigned int N>
+inline
+void FEMContext::side_value(unsigned int var, unsigned int qp,
+                            DualNumber<T,N>& u) const
+{
+  this->_dual_value(var, this->get_side_fe(var)->get_phi(), qp, u);
+}
+
+template<typename T, unsigned int N>
+inline
+void FEMContext::side_gradient(unsigned int var, unsigned int qp,
+                               VectorValue<DualNumber<T,N> >& du) const
+{
+  this->_dual_gradient(var, this->get_side_fe(var)->get_dphi(), qp, du);
+}
+
+template<typename T, unsigned int N>
+inline
+void FEMContext::_dual_value(unsigned int var,
+                             const std::vector<std::vector<Real> > &phi,
+                             unsigned int qp, DualNumber<T,N>& u) const
+{
+  // Get current local coefficients
+  libmesh_assert_greater (elem_subsolutions.size(), var);
+  libmesh_assert(elem_subsolutions[var]);
+  const DenseSubVector<Number> &coef = *elem_subsolutions[var];
+  const unsigned int n_dofs = coef.size();
+
+  u = 0.;
+
+  for (unsigned int l=0; l != n_dofs; l++)
+    u.value() += phi[l][qp] * coef(l);
+
+  // The derivative with respect to each coefficient being
+  // differentiated is its shape function
+  const unsigned int begin = std::max(coef.i_off(), _dual_seed_begin);
+  const unsigned int end = std::min(coef.i_off() + n_dofs, _dual_seed_begin + N);
+
+  for (unsigned int l=begin; l < end; l++)
+    u.derivative(l - _dual_seed_begin) = phi[l - coef.i_off()][qp];
+}
+
+template<typename T, unsigned int N>
+inline
+void FEMContext::_dual_gradient(unsigned int var,
+                                const std::vector<std::vector<RealGradient> > &dphi,
+                                unsigned int qp, VectorValue<DualNumber<T,N> >& du) const
+{
+  libmesh_assert_greater (elem_subsolutions.size(), var);
+  libmesh_assert(elem_subsolutions[var]);
+  const DenseSubVector<Number> &coef = *elem_subsolutions[var];
+  const unsigned int n_dofs = coef.size();
+
+  const unsigned int begin = std::max(coef.i_off(), _dual_seed_begin);
+  const unsigned int end = std::min(coef.i_off() + n_dofs, _dual_seed_begin + N);
+
+  for (unsigned int d=0; d != LIBMESH_DIM; d++)
+    {
+      DualNumber<T,N> &du_d = du(d);
+
+      du_d = 0.;
+
+      for (unsigned int l=0; l != n_dofs; l++)
+        du_d.value() += dphi[l][qp](d) * coef(l);
+
+      for (unsigned int l=begin; l < end; l++)
+        du_d.derivative(l - _dual_seed_begin) = dphi[l - coef.i_off()][qp](d);
+    }
+}
+
+template<unsigned int N, typename ResidualFunctor>
+inline
+void FEMContext::ad_residual(const ResidualFunctor& residual,
+                             bool request_jacobian)
+{
+  const unsigned int n_dofs =
+    libmesh_cast_int<unsigned int>(dof_indices.size());
+
+  // Without a jacobian there is nothing to differentiate
+  if (!request_jacobian)
+    {
+      std::vector<Number> F (n_dofs, 0.);
+      residual (*this, F);
+
+      for (unsigned int i=0; i != n_dofs; i++)
+        elem_residual(i) += F[i];
+
+      return;
+    }
+
+  const Real solution_derivative = this->get_elem_solution_derivative();
+
+  std::vector<DualNumber<Number,N> > F;
+
+  // Differentiate with respect to N degrees of freedom at a time
+  for (_dual_seed_begin = 0; _dual_seed_begin < n_dofs;
+       _dual_seed_begin += N)
+    {
+      F.assign (n_dofs, DualNumber<Number,N>(0.));
+      residual (*this, F);
+
+      const unsigned int n_lanes = std::min(N, n_dofs - _dual_seed_begin);
+
+      for (unsigned int i=0; i != n_dofs; i++)
+        {
+          // The values are the same on every pass
+          if (!_dual_seed_begin)
+            elem_residual(i) += F[i].value();
+
+          for (unsigned int k=0; k != n_lanes; k++)
+            elem_jacobian(i, _dual_seed_begin + k) +=
+              solution_derivative * F[i].derivative(k);
+        }
+    }
+
+  _dual_seed_begin = 0;
+}
+
 
 } // namespace libMesh
 
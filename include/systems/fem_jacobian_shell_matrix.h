@@ -0,0 +1,109 @@
+// The libMesh Finite Element Library.
+// Copyright (C) 2002-2012 Benjamin S. Kirk, John W. Peterson, Roy H. Stogner
+
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+
+
+#ifndef LIBMESH_FEM_JACOBIAN_SHELL_MATRIX_H
+#define LIBMESH_FEM_JACOBIAN_SHELL_MATRIX_H
+
+// Local includes
+#include "libmesh/libmesh_common.h"
+#include "libmesh/shell_matrix.h"
+
+namespace libMesh
+{
+
+// Forward declarations
+class FEMSystem;
+
+
+/**
+ * This class is the Jacobian of an \p FEMSystem at its current
+ * solution, as a shell matrix: its product with a vector is computed
+ * element by element from the system's element Jacobians (analytic or
+ * numerical), without assembling the global Jacobian.  Each product
+ * costs about as much as a Jacobian assembly.
+ *
+ * Attach it to a \p NewtonSolver with \p attach_shell_matrix() for a
+ * Newton-Krylov solve which never assembles the system matrix; this
+ * requires a linear solver which supports shell matrices.
+ */
+class FEMJacobianShellMatrix : public ShellMatrix<Number>
+{
+public:
+  /**
+   * Constructor; takes a reference to the system, which has to be
+   * stored elsewhere.
+   */
+  explicit
+  FEMJacobianShellMatrix (FEMSystem& system);
+
+  /**
+   * Destructor.
+   */
+  virtual ~FEMJacobianShellMatrix ();
+
+  /**
+   * @returns \p m, the row-dimension of the matrix where the marix is
+   * \f$ M \times N \f$.
+   */
+  virtual numeric_index_type m () const;
+
+  /**
+   * @returns \p n, the column-dimension of the matrix where the marix
+   * is \f$ M \times N \f$.
+   */
+  virtual numeric_index_type n () const;
+
+  /**
+   * Multiplies the matrix with \p arg and stores the result in \p
+   * dest.
+   */
+  virtual void vector_mult (NumericVector<Number>& dest,
+			    const NumericVector<Number>& arg) const;
+
+  /**
+   * Multiplies the matrix with \p arg and adds the result to \p dest.
+   */
+  virtual void vector_mult_add (NumericVector<Number>& dest,
+				const NumericVector<Number>& arg) const;
+
+  /**
+   * Copies the diagonal part of the matrix into \p dest.
+   */
+  virtual void get_diagonal (NumericVector<Number>& dest) const;
+
+protected:
+  /**
+   * The system.
+   */
+  FEMSystem& _system;
+};
+
+
+
+//-----------------------------------------------------------------------
+// FEMJacobianShellMatrix inline members
+inline
+FEMJacobianShellMatrix::~FEMJacobianShellMatrix ()
+{}
+
+
+} // namespace libMesh
+
+
+#endif // LIBMESH_FEM_JACOBIAN_SHELL_MATRIX_H
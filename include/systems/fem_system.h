@@ -22,6 +22,7 @@
 
 // Local Includes
 #include "libmesh/diff_system.h"
+#include "libmesh/element_matrix_cache.h"
 #include "libmesh/fem_physics.h"
 
 // C++ includes
@@ -93,6 +94,23 @@ public:
    */
   virtual void assembly (bool get_residual, bool get_jacobian);
 
+  /**
+   * Adds the product of the Jacobian at the current solution with
+   * \p v to \p dest.  The element Jacobians are computed as in
+   * \p assembly() and applied to \p v directly, so the global
+   * Jacobian is never assembled.  This is the action of a
+   * \p FEMJacobianShellMatrix.
+   */
+  void jacobian_vector_mult_add (NumericVector<Number>& dest,
+                                 const NumericVector<Number>& v);
+
+  /**
+   * Adds the diagonal of the Jacobian at the current solution to
+   * \p dest, computed element by element as in
+   * \p jacobian_vector_mult_add().
+   */
+  void jacobian_diagonal_add (NumericVector<Number>& dest);
+
   /**
    * Invokes the solver associated with the system.  For steady state
    * solvers, this will find a root x where F(x) = 0.  For transient
@@ -190,6 +208,45 @@ public:
    */
   Real verify_analytic_jacobians;
 
+  /**
+   * If map_batch_size is nonzero, assembly loops will compute the
+   * element maps of blocks of up to map_batch_size affine elements
+   * at once with FEMContext::batch_elem_maps(), rather than one
+   * element at a time.  It is zero by default.
+   */
+  unsigned int map_batch_size;
+
+  /**
+   * If cache_element_jacobians is true, assembly() stores the
+   * element jacobians it computes in \p element_jacobian_cache, and
+   * on elements which are translates of an element already in the
+   * cache only computes the residual.  This is only correct if the
+   * element jacobians do not depend on the solution or on the
+   * position of the element, e.g. for linear constant coefficient
+   * problems; any other data they depend on should be added to the
+   * cache key by element_jacobian_coefficients().  The time step
+   * size is always added.  It is false by default, and ignored on
+   * moving meshes and while verify_analytic_jacobians is nonzero.
+   */
+  bool cache_element_jacobians;
+
+  /**
+   * The element jacobians cached by assembly(), and the hit rate of
+   * the cache.  It is emptied by clear(), and should be emptied by
+   * users whenever the element jacobians change in any way not
+   * captured by its keys.
+   */
+  ElementMatrixCache element_jacobian_cache;
+
+  /**
+   * Appends to \p coefficients any data besides the element geometry
+   * which the element jacobian on the element of \p context depends
+   * on, to be added to its key in the \p element_jacobian_cache.
+   * The default implementation adds nothing.
+   */
+  virtual void element_jacobian_coefficients (const FEMContext& /* context */,
+                                              std::vector<Real>& /* coefficients */) const {}
+
   /**
    * Syntax sugar to make numerical_jacobian() declaration easier.
    */
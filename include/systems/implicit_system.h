@@ -327,6 +327,12 @@ public:
    */
   virtual unsigned int n_matrices () const;
 
+  /**
+   * @returns an estimate of the number of bytes of memory used on
+   * this processor by the matrices of this system.
+   */
+  virtual std::size_t matrix_memory_usage () const;
+
   /**
    * The system matrix.  Implicit systems are characterized by
    * the need to solve the linear system Ax=b.  This is the
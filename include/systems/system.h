@@ -1275,6 +1275,27 @@ public:
    */
   std::string get_info () const;
 
+  /**
+   * @returns an estimate of the number of bytes of memory used on
+   * this processor by the vectors of this system.  Derived classes
+   * which own additional vectors should add them.
+   */
+  virtual std::size_t vector_memory_usage () const;
+
+  /**
+   * @returns an estimate of the number of bytes of memory used on
+   * this processor by the matrices of this system.  The base class
+   * has no matrices.
+   */
+  virtual std::size_t matrix_memory_usage () const { return 0; }
+
+  /**
+   * @returns an estimate of the number of bytes of memory used on
+   * this processor by the \p DofMap, vectors and matrices of this
+   * system.
+   */
+  virtual std::size_t memory_usage () const;
+
   /**
    * Register a user function to use in initializing the system.
    */
@@ -26,15 +26,26 @@
 
 // C++ includes
 #include <cstddef>
+#include <limits>
 #include <map>
-#include <stack>
 #include <string>
+#include <utility>
 #include <vector>
 #include <sys/time.h>
+#include <time.h>
+
+#ifdef LIBMESH_HAVE_PTHREAD
+#  include <pthread.h>
+#endif
 
 namespace libMesh
 {
 
+// Forward Declarations
+namespace Parallel {
+  class Communicator;
+}
+
 /**
  * The \p PerfData class simply contains the performance
  * data that is recorded for individual events.
@@ -52,8 +63,8 @@ class PerfData
   PerfData () :
     tot_time(0.),
     tot_time_incl_sub(0.),
-    tstart(),
-    tstart_incl_sub(),
+    tstart(0.),
+    tstart_incl_sub(0.),
     count(0),
     open(false),
     called_recursively(0)
@@ -71,16 +82,16 @@ class PerfData
   double tot_time_incl_sub;
 
   /**
-   * Structure defining when the event
-   * was last started.
+   * The \p wall_time() when the event
+   * was last started or restarted.
    */
-  struct timeval tstart;
+  double tstart;
 
   /**
-   * Structure defining when the event
+   * The \p wall_time() when the event
    * was last started, including sub-events.
    */
-  struct timeval tstart_incl_sub;
+  double tstart_incl_sub;
 
   /**
    * The number of times this event has
@@ -102,6 +113,13 @@ class PerfData
 
   int called_recursively;
 
+  /**
+   * @returns the current time in seconds, measured by a monotonic
+   * clock where one is available, so that events are not skewed
+   * by adjustments to the system time.
+   */
+  static double wall_time ();
+
  protected:
   double stop_or_pause(const bool do_stop);
 };
@@ -116,6 +134,18 @@ class PerfData
  * This class is particulary useful for finding performance
  * bottlenecks.
  *
+ * Each event is interned the first time it is seen, and may then be
+ * pushed and popped by its integer \p event_id(), which avoids any
+ * string comparisons on the hot path.  Every thread records the
+ * events it runs in its own call tree, so events may be logged from
+ * within threaded loops; the trees are merged only when the log is
+ * printed.  The times reported for each event are then summed over
+ * threads, and so is the active time.
+ *
+ * Optionally the log also records a timeline of every event, which
+ * can be written with \p write_trace() and inspected in a trace
+ * viewer, and samples hardware performance counters for each event.
+ *
  */
 
 // ------------------------------------------------------------
@@ -146,6 +176,7 @@ class PerfLog
    * checks to see if it is currently monitoring any
    * events, and if so errors.  Be sure you are not
    * logging any events when you call this function.
+   * Event ids remain valid.
    */
   void clear();
 
@@ -164,18 +195,118 @@ class PerfLog
    */
   bool logging_enabled() const { return log_events; }
 
+  /**
+   * Enables printing of the merged call tree after the
+   * flat event summary in \p get_log().
+   */
+  void enable_call_tree_output() { print_call_tree = true; }
+
+  /**
+   * Disables printing of the call tree.
+   */
+  void disable_call_tree_output() { print_call_tree = false; }
+
+  /**
+   * Enables recording the start and end time of every event, for
+   * \p write_trace().  Each event recorded takes a few dozen bytes.
+   */
+  void enable_tracing() { record_trace = true; }
+
+  /**
+   * Disables recording the timeline of events.
+   */
+  void disable_tracing() { record_trace = false; }
+
+  /**
+   * Enables sampling the cycles, instructions and last level cache
+   * misses of each event from the Linux perf_event interface.  Each
+   * sample is a system call, so this adds some overhead to every
+   * event.  If the counters can not be opened, for instance because
+   * the kernel does not allow unprivileged processes to read them,
+   * a warning is printed and no counts are recorded.
+   */
+  void enable_hardware_counters();
+
+  /**
+   * Disables sampling hardware counters.
+   */
+  void disable_hardware_counters() { read_counters = false; }
+
+  /**
+   * @returns the id of the event \p label under \p header,
+   * interning the event if it has not been seen before.  The id
+   * may be cached by the caller and passed to \p push() and
+   * \p pop(); this function may be called from multiple threads.
+   */
+  unsigned int event_id (const std::string &label,
+			 const std::string &header="");
+
+  /**
+   * @returns the (header, label) pair of the event with id \p event.
+   */
+  std::pair<std::string, std::string> event_name (const unsigned int event) const;
+
+  /**
+   * @returns the id of the innermost event running on the calling
+   * thread whose header does not begin with \p excluded_header, or
+   * \p libMesh::invalid_uint if there is none.
+   */
+  unsigned int current_event (const std::string &excluded_header="");
+
   /**
    * Push the event \p label onto the stack, pausing any active event.
    */
   void push (const std::string &label,
 	     const std::string &header="");
 
+  /**
+   * Push the event with id \p event onto the calling thread's stack,
+   * pausing any active event on that thread.
+   */
+  void push (const unsigned int event);
+
   /**
    * Pop the event \p label off the stack, resuming any lower event.
    */
   void pop (const std::string &label,
 	    const std::string &header="");
 
+  /**
+   * Pop the event with id \p event off the calling thread's stack,
+   * resuming any lower event on that thread.
+   */
+  void pop (const unsigned int event);
+
+  /**
+   * The event logged at one place in the code, as used by the
+   * \p START_LOG and \p STOP_LOG macros.  An event named by string
+   * literals is interned once, when the site is first reached; an
+   * event named by other strings, which may differ from call to
+   * call, is looked up every time.
+   */
+  class EventSite
+  {
+  public:
+    template <std::size_t N, std::size_t M>
+    EventSite (PerfLog &log, const char (&label)[N], const char (&header)[M]) :
+      _event(log.event_id(label, header)) {}
+
+    EventSite (PerfLog &, const std::string &, const std::string &) :
+      _event(std::numeric_limits<unsigned int>::max()) {}
+
+    template <std::size_t N, std::size_t M>
+    unsigned int event_id (PerfLog &, const char (&)[N], const char (&)[M]) const
+    { return _event; }
+
+    unsigned int event_id (PerfLog &log,
+			   const std::string &label,
+			   const std::string &header) const
+    { return log.event_id(label, header); }
+
+  private:
+    const unsigned int _event;
+  };
+
   /**
    * Start monitoring the event named \p label.
    */
@@ -204,6 +335,8 @@ class PerfLog
    * @returns a string containing:
    * (1) Basic machine information (if first call)
    * (2) The performance log
+   * (3) The call tree, if enabled
+   * (4) The hardware counts, if enabled
    */
   std::string get_log() const;
 
@@ -217,6 +350,31 @@ class PerfLog
    */
   std::string get_perf_info() const;
 
+  /**
+   * @returns a string containing the call tree of all logged
+   * events, merged over threads.  Each event is listed under the
+   * event it was started from, with the time spent in it on
+   * that path.
+   */
+  std::string get_call_tree_info() const;
+
+  /**
+   * @returns a string containing the hardware counts of each event,
+   * excluding sub-events and summed over threads.
+   */
+  std::string get_counter_info() const;
+
+  /**
+   * Writes the timelines recorded on every processor of \p comm to
+   * \p filename, as Chrome trace event JSON, with a process for each
+   * processor and a thread for each thread.  The clocks of all
+   * processors are aligned at a barrier at the start of the call.
+   * Only processor 0 writes.  This function must be called by all
+   * processors in \p comm.
+   */
+  void write_trace (const std::string &filename,
+		    const Parallel::Communicator &comm) const;
+
   /**
    * Print the log.
    */
@@ -228,17 +386,152 @@ class PerfLog
   double get_elapsed_time() const;
 
   /**
-   * @returns the active time
+   * @returns the active time, summed over threads.
    */
   double get_active_time() const;
 
   /**
-   * Return the PerfData object associated with a label and header.
+   * Return the PerfData object associated with a label and header,
+   * summed over all the places in the call tree it was called from.
    */
   PerfData get_perf_data(const std::string &label, const std::string &header="");
 
  private:
 
+  /**
+   * Logs own their per-thread data and are not copyable.
+   */
+  PerfLog (const PerfLog&);
+  PerfLog& operator= (const PerfLog&);
+
+  /**
+   * The number of hardware counters sampled for each event.
+   */
+  static const unsigned int n_counters = 3;
+
+  /**
+   * A node of a call tree: one event, as called from the path
+   * of events leading to its parent node.
+   */
+  struct CallTreeNode
+  {
+    CallTreeNode (const unsigned int e, const unsigned int p) :
+      event(e), parent(p)
+    {
+      for (unsigned int i=0; i != n_counters; ++i)
+	counts[i] = 0.;
+    }
+
+    unsigned int event;
+
+    unsigned int parent;
+
+    /**
+     * The (event, node) pairs of the events called from this one,
+     * in the order they were first called.
+     */
+    std::vector<std::pair<unsigned int, unsigned int> > children;
+
+    PerfData data;
+
+    /**
+     * The hardware counts for this event, excluding sub-events.
+     */
+    double counts[n_counters];
+  };
+
+  /**
+   * One call of an event, as recorded in a timeline.
+   */
+  struct TraceEvent
+  {
+    TraceEvent (const unsigned int e, const double b, const double en) :
+      event(e), begin(b), end(en) {}
+
+    unsigned int event;
+
+    double begin, end;
+  };
+
+  /**
+   * The log of a single thread.
+   */
+  struct ThreadLog
+  {
+    ThreadLog ();
+
+    ~ThreadLog ();
+
+    /**
+     * The call tree.  Node 0 is a root which is never timed.
+     */
+    std::vector<CallTreeNode> nodes;
+
+    /**
+     * The nodes of the currently running events, starting with
+     * the root.
+     */
+    std::vector<unsigned int> stack;
+
+    /**
+     * The event ids this thread has already looked up, by header
+     * and then label, so that the shared event table is only locked
+     * on first use.
+     */
+    std::map<std::string, std::map<std::string, unsigned int> > event_ids;
+
+    /**
+     * The running time for events recorded on this thread.
+     */
+    double active_time;
+
+    /**
+     * The timeline of events which have finished on this thread.
+     */
+    std::vector<TraceEvent> trace;
+
+    /**
+     * The file descriptors of this thread's hardware counters, the
+     * first of which leads the group.  Negative until opened.
+     */
+    int counter_fds[n_counters];
+
+    /**
+     * Whether the counters have been opened, or have failed to.
+     */
+    bool counters_opened;
+
+    /**
+     * The counter values when they were last sampled.
+     */
+    double counter_values[n_counters];
+  };
+
+  /**
+   * @returns the log of the calling thread, creating it if needed.
+   */
+  ThreadLog & thread_log ();
+
+  /**
+   * Samples the hardware counters of the calling thread, and adds
+   * the counts since the previous sample to \p node of its call
+   * tree, unless \p node is the root.
+   */
+  void update_counters (ThreadLog &tl, const unsigned int node);
+
+  /**
+   * Sums the data of every node of every thread's call tree into
+   * one entry per (header, label) pair.  Inclusive times of
+   * recursive calls are only counted once.
+   */
+  void merge_events (std::map<std::pair<std::string, std::string>,
+		                      PerfData> &merged) const;
+
+  /**
+   * Merges the call trees of every thread into \p merged, matching
+   * nodes by the path of events from the root.
+   */
+  void merge_call_trees (std::vector<CallTreeNode> &merged) const;
 
   /**
    * The label for this object.
@@ -251,26 +544,46 @@ class PerfLog
   bool log_events;
 
   /**
-   * The total running time for recorded events.
+   * Flag to print the call tree with the log.
+   */
+  bool print_call_tree;
+
+  /**
+   * Flag to record a timeline of events.
    */
-  double total_time;
+  bool record_trace;
+
+  /**
+   * Flag to sample hardware counters.
+   */
+  bool read_counters;
 
   /**
    * The time we were constructed or last cleared.
    */
-  struct timeval tstart;
+  double tstart;
+
+  /**
+   * The (header, label) pair of each interned event, by id.
+   */
+  std::vector<std::pair<std::string, std::string> > event_names;
+
+  /**
+   * The id of each interned (header, label) pair.
+   */
+  std::map<std::pair<std::string, std::string>, unsigned int> event_ids;
 
   /**
-   * The actual log.
+   * The logs of every thread which has logged an event.
    */
-  std::map<std::pair<std::string,
-		     std::string>,
-	   PerfData> log;
+  std::vector<ThreadLog*> thread_logs;
 
+#ifdef LIBMESH_HAVE_PTHREAD
   /**
-   * A stack to hold the current performance log trace.
+   * The key under which each thread finds its own log.
    */
-  std::stack<PerfData*> log_stack;
+  pthread_key_t thread_log_key;
+#endif
 
   /**
    * Flag indicating if print_log() has been called.
@@ -291,12 +604,34 @@ class PerfLog
 
 // ------------------------------------------------------------
 // PerfData class member funcions
+inline
+double PerfData::wall_time ()
+{
+#ifdef CLOCK_MONOTONIC
+  struct timespec tnow;
+
+  clock_gettime (CLOCK_MONOTONIC, &tnow);
+
+  return (static_cast<double>(tnow.tv_sec) +
+	  static_cast<double>(tnow.tv_nsec)*1.e-9);
+#else
+  struct timeval tnow;
+
+  gettimeofday (&tnow, NULL);
+
+  return (static_cast<double>(tnow.tv_sec) +
+	  static_cast<double>(tnow.tv_usec)*1.e-6);
+#endif
+}
+
+
+
 inline
 void PerfData::start ()
 {
   this->count++;
   this->called_recursively++;
-  gettimeofday (&(this->tstart), NULL);
+  this->tstart = wall_time();
   this->tstart_incl_sub = this->tstart;
 }
 
@@ -305,7 +640,7 @@ void PerfData::start ()
 inline
 void PerfData::restart ()
 {
-  gettimeofday (&(this->tstart), NULL);
+  this->tstart = wall_time();
 }
 
 
@@ -320,26 +655,16 @@ double PerfData::pause ()
 inline
 double PerfData::stop_or_pause(const bool do_stop)
 {
-  // save the start times, reuse the structure we have rather than create
-  // a new one.
-  const time_t
-    tstart_tv_sec  = this->tstart.tv_sec,
-    tstart_tv_usec = this->tstart.tv_usec;
-
-  gettimeofday (&(this->tstart), NULL);
+  const double tnow = wall_time();
 
-  const double elapsed_time = (static_cast<double>(this->tstart.tv_sec  - tstart_tv_sec) +
-			       static_cast<double>(this->tstart.tv_usec - tstart_tv_usec)*1.e-6);
+  const double elapsed_time = tnow - this->tstart;
 
   this->tot_time += elapsed_time;
 
-  if(do_stop)
-    {
-      const double elapsed_time_incl_sub = (static_cast<double>(this->tstart.tv_sec  - this->tstart_incl_sub.tv_sec) +
-					    static_cast<double>(this->tstart.tv_usec - this->tstart_incl_sub.tv_usec)*1.e-6);
+  this->tstart = tnow;
 
-      this->tot_time_incl_sub += elapsed_time_incl_sub;
-    }
+  if(do_stop)
+    this->tot_time_incl_sub += tnow - this->tstart_incl_sub;
 
   return elapsed_time;
 }
@@ -365,53 +690,17 @@ void PerfLog::push (const std::string &label,
 		    const std::string &header)
 {
   if (this->log_events)
-    {
-      // Get a reference to the event data to avoid
-      // repeated map lookups
-      PerfData *perf_data = &(log[std::make_pair(header,label)]);
-
-      if (!log_stack.empty())
-	total_time +=
-	  log_stack.top()->pause();
-
-      perf_data->start();
-      log_stack.push(perf_data);
-    }
+    this->push(this->event_id(label, header));
 }
 
 
 
 inline
-void PerfLog::pop (const std::string &libmesh_dbg_var(label),
-		   const std::string &libmesh_dbg_var(header))
+void PerfLog::pop (const std::string &label,
+		   const std::string &header)
 {
   if (this->log_events)
-    {
-      libmesh_assert (!log_stack.empty());
-
-#ifndef NDEBUG
-      PerfData *perf_data = &(log[std::make_pair(header,label)]);
-      if (perf_data != log_stack.top())
-        {
-          libMesh::err << "PerfLog can't pop (" << header << ',' << label << ')' << std::endl;
-          libMesh::err << "From top of stack of running logs:" << std::endl;
-          std::map<std::pair<std::string, std::string>, PerfData>::iterator
-            i = log.begin(), endi = log.end();
-          for (; i != endi; ++i)
-            if (&(i->second) == log_stack.top())
-              libMesh::err << '(' << i->first.first << ',' << i->first.second << ')' << std::endl;
-
-          libmesh_assert_equal_to (perf_data, log_stack.top());
-        }
-#endif
-
-      total_time += log_stack.top()->stopit();
-
-      log_stack.pop();
-
-      if (!log_stack.empty())
-	log_stack.top()->restart();
-    }
+    this->pop(this->event_id(label, header));
 }
 
 
@@ -419,19 +708,7 @@ void PerfLog::pop (const std::string &libmesh_dbg_var(label),
 inline
 double PerfLog::get_elapsed_time () const
 {
-  struct timeval tnow;
-
-  gettimeofday (&tnow, NULL);
-
-  const double elapsed_time = (static_cast<double>(tnow.tv_sec  - tstart.tv_sec) +
-			       static_cast<double>(tnow.tv_usec - tstart.tv_usec)*1.e-6);
-  return elapsed_time;
-}
-
-inline
-double PerfLog::get_active_time() const
-{
-  return total_time;
+  return PerfData::wall_time() - tstart;
 }
 
 } // namespace libMesh
@@ -101,6 +101,13 @@ public:
    */
   virtual const Elem* operator() (const Point& p) const = 0;
 
+  /**
+   * @returns an estimate of the number of bytes of memory used by
+   * the \p PointLocator.  Data shared with a master is only counted
+   * by the master.  Pure virtual.
+   */
+  virtual std::size_t memory_usage () const = 0;
+
   /**
    * @returns \p true when this object is properly initialized
    * and ready for use, \p false otherwise.
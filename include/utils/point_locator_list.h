@@ -108,6 +108,12 @@ public:
    */
   virtual const Elem* operator() (const Point& p) const;
 
+  /**
+   * @returns an estimate of the number of bytes of memory used by
+   * the list, if we are the master.
+   */
+  virtual std::size_t memory_usage () const;
+
   /**
    * Enables out-of-mesh mode.  In this mode, if asked to find a point
    * that is contained in no mesh at all, the point locator will
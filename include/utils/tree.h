@@ -78,6 +78,13 @@ public:
    */
   unsigned int n_active_bins() const { return root.n_active_bins(); }
 
+  /**
+   * @returns an estimate of the number of bytes of memory used by
+   * the tree.
+   */
+  std::size_t memory_usage() const
+  { return sizeof(Tree<N>) + root.memory_usage() - sizeof(TreeNode<N>); }
+
   /**
    * @returns a pointer to the element containing point p.
    */
@@ -89,6 +89,12 @@ public:
    */
   virtual unsigned int n_active_bins() const = 0;
 
+  /**
+   * @returns an estimate of the number of bytes of memory used by
+   * the tree.
+   */
+  virtual std::size_t memory_usage() const = 0;
+
   /**
    * @returns a pointer to the element containing point p.
    */
@@ -139,6 +139,12 @@ public:
    */
   unsigned int n_active_bins() const;
 
+  /**
+   * @returns an estimate of the number of bytes of memory used by
+   * this node and all of its children.
+   */
+  std::size_t memory_usage() const;
+
   /**
    * @returns an element containing point p.
    */
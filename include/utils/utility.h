@@ -227,6 +227,41 @@ namespace Utility
   }
 
 
+  //-------------------------------------------------------------------
+  /**
+   * @returns the number of bytes of heap memory reserved by \p vec.
+   */
+  template <typename T, typename A>
+  std::size_t memory_usage (const std::vector<T,A> &vec)
+  {
+    return vec.capacity() * sizeof(T);
+  }
+
+
+  //-------------------------------------------------------------------
+  /**
+   * @returns an estimate of the number of bytes of heap memory used
+   * by the node-based container \p c, e.g. a \p std::map or
+   * \p std::set.  Each entry is assumed to cost its own size plus
+   * the four words of a typical red-black tree node.  Memory owned
+   * by the entries themselves is not counted.
+   */
+  template <typename Container>
+  std::size_t tree_memory_usage (const Container &c)
+  {
+    return c.size() * (sizeof(typename Container::value_type) +
+                       4*sizeof(void*));
+  }
+
+
+  //-------------------------------------------------------------------
+  /**
+   * @returns the largest resident set size this process has reached,
+   * in bytes, or 0 if the operating system does not tell us.
+   */
+  std::size_t peak_memory_usage ();
+
+
   //-------------------------------------------------------------------
   // Utility functions useful when dealing with complex numbers.
 
@@ -0,0 +1,89 @@
+#ifndef __fe_mesh_test_h__
+#define __fe_mesh_test_h__
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestCase.h>
+
+#include <libmesh/mesh.h>
+#include <libmesh/mesh_generation.h>
+#include <libmesh/mesh_modification.h>
+#include <libmesh/node.h>
+
+#define FEMESHTEST \
+  CPPUNIT_TEST( testTri ); \
+  CPPUNIT_TEST( testTet ); \
+  CPPUNIT_TEST( testDistortedHex );
+
+using namespace libMesh;
+
+// Rotates \p mesh so that no element edge or face is aligned with the
+// coordinate planes
+inline void rotateOffAxes (MeshBase &mesh)
+{
+  MeshTools::Modification::rotate (mesh, 150., 30., 60.);
+}
+
+// Moves the node at \p p by \p offset, so that the elements around it
+// are no longer affine
+inline void moveNode (MeshBase &mesh, const Point &p, const Point &offset)
+{
+  MeshBase::node_iterator       nd     = mesh.nodes_begin();
+  const MeshBase::node_iterator end_nd = mesh.nodes_end();
+  for ( ; nd != end_nd; ++nd)
+    if ((**nd).absolute_fuzzy_equals(p))
+      **nd += offset;
+}
+
+
+
+// The meshes shared by the FE map tests: affine triangles and
+// tetrahedra rotated off the coordinate planes, and hexes of which
+// the bottom layer is distorted and the top layer affine.  The
+// DerivedClass provides checkMesh(mesh, dim), which is run on each.
+template <class DerivedClass>
+class FEMeshTest : public CppUnit::TestCase {
+
+public:
+  void setUp()
+  {}
+
+  void tearDown()
+  {}
+
+
+#ifndef LIBMESH_DISABLE_COMMWORLD
+
+  void testTri()
+  {
+    Mesh mesh(CommWorld);
+    MeshTools::Generation::build_square (mesh, 3, 3, 0., 1., 0., 1., TRI6);
+    rotateOffAxes (mesh);
+
+    static_cast<DerivedClass*>(this)->checkMesh (mesh, 2);
+  }
+
+
+
+  void testTet()
+  {
+    Mesh mesh(CommWorld);
+    MeshTools::Generation::build_cube (mesh, 2, 2, 2, 0., 1., 0., 1., 0., 1., TET4);
+    rotateOffAxes (mesh);
+
+    static_cast<DerivedClass*>(this)->checkMesh (mesh, 3);
+  }
+
+
+
+  void testDistortedHex()
+  {
+    Mesh mesh(CommWorld);
+    MeshTools::Generation::build_cube (mesh, 2, 2, 2, 0., 1., 0., 1., 0., 1., HEX8);
+    moveNode (mesh, Point(0.5, 0.5, 0.), Point(0.1, 0.05, 0.08));
+
+    static_cast<DerivedClass*>(this)->checkMesh (mesh, 3);
+  }
+#endif // !LIBMESH_DISABLE_COMMWORLD
+};
+
+#endif // __fe_mesh_test_h__
@@ -0,0 +1,133 @@
+#ifndef LIBMESH_PERF_MEASUREMENT_H
+#define LIBMESH_PERF_MEASUREMENT_H
+
+#include <libmesh/libmesh_common.h>
+#include <libmesh/parallel.h>
+
+#include <iostream>
+#include <map>
+#include <string>
+
+/**
+ * Measures the wall time and the number of memory allocations of a
+ * region of a performance test.  The time is the maximum over the
+ * processors, and the allocations are summed over the processors.
+ * Allocations are counted by the replacement operator new in
+ * perf_measurement.C, on all threads, so this file must only be
+ * linked into the performance test program.
+ */
+class PerfMeasurement
+{
+public:
+  PerfMeasurement (const libMesh::Parallel::Communicator &comm);
+
+  /**
+   * Starts measuring, after a barrier.
+   */
+  void start ();
+
+  /**
+   * Stops measuring, and collects the results from all processors.
+   */
+  void stop ();
+
+  double time () const { return _time; }
+
+  /**
+   * @returns the time measured relative to \p reference_time(), which
+   * makes it comparable between machines of different speeds.
+   */
+  double relative_time () const;
+
+  double allocations () const { return _allocations; }
+
+  /**
+   * @returns the number of allocations made so far by this processor.
+   */
+  static std::size_t allocation_count ();
+
+  /**
+   * @returns the wall time of a fixed reference kernel, which is run
+   * the first time this is called.  This is the maximum over the
+   * processors of \p comm.
+   */
+  static double reference_time (const libMesh::Parallel::Communicator &comm);
+
+private:
+  const libMesh::Parallel::Communicator &_comm;
+  double _start_time;
+  static double _reference_time;
+  std::size_t _start_allocations;
+  double _time;
+  double _allocations;
+};
+
+
+
+/**
+ * The checked-in baselines of the performance tests, and the results
+ * of this run.  The baselines file is a GetPot input file with a
+ * section for each test:
+ *
+ * [assemble_laplacian]
+ *   n_processors         = 1
+ *   relative_time        = 12.5   # multiples of the reference time
+ *   time_tolerance       = 0.5    # fractional slowdown allowed
+ *   allocations          = 1000
+ *   allocation_tolerance = 0.1
+ * []
+ *
+ * Times are stored as ratios to PerfMeasurement::reference_time(), so
+ * that the baselines of one machine can be checked on another.  A
+ * test fails if it is slower, or allocates more, than its baseline
+ * by more than the tolerance.  Baselines are only compared on the
+ * number of processors they were measured on; tests without a
+ * baseline only report their results.
+ */
+class PerfBaselines
+{
+public:
+  /**
+   * Reads the baselines from \p filename.
+   */
+  static void read (const std::string &filename);
+
+  /**
+   * Replaces the time tolerances of all the baselines by \p tolerance.
+   */
+  static void set_time_tolerance (const double tolerance);
+
+  /**
+   * Records the measurement \p m of test \p name, and asserts that it
+   * is within the tolerances of the test's baseline.
+   */
+  static void check (const std::string &name,
+                     const PerfMeasurement &m,
+                     const libMesh::Parallel::Communicator &comm);
+
+  /**
+   * Writes the results of this run in the format of the baselines
+   * file, keeping the tolerances of existing baselines.
+   */
+  static void write (std::ostream &os);
+
+private:
+  struct Entry
+  {
+    Entry () :
+      n_processors(0), relative_time(-1.), time_tolerance(0.5),
+      allocations(-1.), allocation_tolerance(0.1) {}
+
+    unsigned int n_processors;
+    double relative_time, time_tolerance;
+    double allocations, allocation_tolerance;
+  };
+
+  static std::map<std::string, Entry> _baselines;
+
+  static std::map<std::string, Entry> _results;
+
+  static double _time_tolerance;
+};
+
+#endif // LIBMESH_PERF_MEASUREMENT_H
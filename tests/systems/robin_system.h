@@ -0,0 +1,111 @@
+#ifndef __robin_system_h__
+#define __robin_system_h__
+
+#include <libmesh/boundary_info.h>
+#include <libmesh/fe_base.h>
+#include <libmesh/fem_context.h>
+#include <libmesh/fem_system.h>
+
+using namespace libMesh;
+
+// The linear system assembled by the FEMSystem tests:
+// -div(grad u) + u = 1, with a Robin condition whose coefficient
+// depends on the boundary id
+class RobinSystem : public FEMSystem
+{
+public:
+  RobinSystem (EquationSystems& es,
+               const std::string& name,
+               const unsigned int number)
+    : FEMSystem(es, name, number) {}
+
+  virtual void init_data ()
+  {
+    this->add_variable ("u", FIRST);
+
+    FEMSystem::init_data();
+  }
+
+  virtual void init_context (DiffContext &context)
+  {
+    FEMContext &c = libmesh_cast_ref<FEMContext&>(context);
+
+    FEBase* elem_fe = c.get_element_fe(0);
+    elem_fe->get_JxW();
+    elem_fe->get_phi();
+    elem_fe->get_dphi();
+
+    FEBase* side_fe = c.get_side_fe(0);
+    side_fe->get_JxW();
+    side_fe->get_phi();
+  }
+
+  virtual bool element_time_derivative (bool request_jacobian,
+                                        DiffContext &context)
+  {
+    FEMContext &c = libmesh_cast_ref<FEMContext&>(context);
+
+    const FEBase* fe = c.get_element_fe(0);
+    const std::vector<Real> &JxW = fe->get_JxW();
+    const std::vector<std::vector<Real> > &phi = fe->get_phi();
+    const std::vector<std::vector<RealGradient> > &dphi = fe->get_dphi();
+
+    DenseSubVector<Number> &F = c.get_elem_residual(0);
+    DenseSubMatrix<Number> &K = c.get_elem_jacobian(0,0);
+
+    for (unsigned int qp=0; qp != JxW.size(); ++qp)
+      {
+        Number u;
+        Gradient grad_u;
+        c.interior_value(0, qp, u);
+        c.interior_gradient(0, qp, grad_u);
+
+        for (unsigned int i=0; i != phi.size(); ++i)
+          {
+            F(i) += JxW[qp] * (grad_u * dphi[i][qp] + (u - 1.) * phi[i][qp]);
+
+            if (request_jacobian)
+              for (unsigned int j=0; j != phi.size(); ++j)
+                K(i,j) += JxW[qp] *
+                  (dphi[j][qp] * dphi[i][qp] + phi[j][qp] * phi[i][qp]);
+          }
+      }
+
+    return request_jacobian;
+  }
+
+  virtual bool side_time_derivative (bool request_jacobian,
+                                     DiffContext &context)
+  {
+    FEMContext &c = libmesh_cast_ref<FEMContext&>(context);
+
+    const Real alpha = 1. +
+      this->get_mesh().boundary_info->boundary_id(&c.get_elem(), c.side);
+
+    const FEBase* fe = c.get_side_fe(0);
+    const std::vector<Real> &JxW = fe->get_JxW();
+    const std::vector<std::vector<Real> > &phi = fe->get_phi();
+
+    DenseSubVector<Number> &F = c.get_elem_residual(0);
+    DenseSubMatrix<Number> &K = c.get_elem_jacobian(0,0);
+
+    for (unsigned int qp=0; qp != JxW.size(); ++qp)
+      {
+        Number u;
+        c.side_value(0, qp, u);
+
+        for (unsigned int i=0; i != phi.size(); ++i)
+          {
+            F(i) += JxW[qp] * alpha * u * phi[i][qp];
+
+            if (request_jacobian)
+              for (unsigned int j=0; j != phi.size(); ++j)
+                K(i,j) += JxW[qp] * alpha * phi[j][qp] * phi[i][qp];
+          }
+      }
+
+    return request_jacobian;
+  }
+};
+
+#endif // __robin_system_h__